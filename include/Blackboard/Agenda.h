@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace blackboard {
+
+// Indexed binary max-heap of entries identified by small, dense IDs, so that entries can be
+// pushed, popped, rescored or removed in O(log n). Entries with equal scores are popped in the
+// order they were pushed.
+//
+class Agenda {
+public:
+    using EntryId = std::size_t;
+
+    Agenda();
+    ~Agenda();
+
+    void Push(EntryId entryId, double score);
+    void Update(EntryId entryId, double score);
+    void Remove(EntryId entryId);
+    EntryId Pop();
+
+    bool Contains(EntryId entryId) const;
+    EntryId GetTop() const;
+    double GetScore(EntryId entryId) const;
+    bool IsEmpty() const;
+    std::size_t GetSize() const;
+
+private:
+    struct Entry {
+        EntryId entryId;
+        double score;
+        std::uint64_t sequence;
+    };
+
+    static bool IsBefore(const Entry& first, const Entry& second);
+
+    void Place(std::size_t heapIndex, Entry&& entry);
+    void SiftUp(std::size_t heapIndex);
+    void SiftDown(std::size_t heapIndex);
+
+    std::vector<Entry> heap;
+    // Position of each entry in the heap, indexed by its ID.
+    std::vector<std::size_t> heapIndices;
+    std::uint64_t nextSequence;
+};
+
+} // namespace blackboard
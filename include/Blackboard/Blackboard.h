@@ -3,34 +3,140 @@
 
 #pragma once
 
+#include "Blackboard/Channel.h"
+#include "Blackboard/EventFilter.h"
+#include "Blackboard/Executor.h"
+#include "Blackboard/InlineFunction.h"
 #include "Blackboard/Object.h"
+#include "Blackboard/RingBuffer.h"
+#include "Blackboard/Span.h"
+#include "Blackboard/ThreadPool.h"
 #include "Blackboard/Utilities.h"
+#include "Blackboard/Value.h"
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
-#include <list>
+#include <limits>
 #include <map>
 #include <memory>
-#include <queue>
 #include <string_view>
 #include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace blackboard {
 
 using EventHandlerUniqueId = std::size_t;
+using EventHandlerPriority = int;
 
 class Blackboard {
 
 public:
     using Event = std::string;
     using EventID = std::string_view;
-    using EventHandler = std::function<bool(EventID, const Object&)>;
 
     enum class CallEventHandlerOnce : bool {
         No,
         Yes
     };
 
+    // Consecutive parallel-safe handlers of an event are invoked concurrently on a worker pool,
+    // while the posting thread waits for all of them to return. Such handlers must not add
+    // handlers or remove other ones, and every one of them runs even if another stops the
+    // invocation loop; the stop, as well as the removal of one-time handlers and of handlers that
+    // removed themselves, takes effect once the group has returned. Events they post while the
+    // waiting thread is dispatching them are queued instead, since dispatching them would block.
+    enum class ParallelSafe : bool {
+        No,
+        Yes
+    };
+
+    // Returned by checked event handlers, in order to control the invocation loop without throwing.
+    enum class InvocationResult {
+        Continue,
+        Stop,
+        Error
+    };
+
+    enum class DispatchResult {
+        Success,
+        UnhandledEvent,
+        HandlerError,
+        ExceptionPosted,
+        DeadlineMissed
+    };
+
+    // Queued events are processed by descending priority and, within a priority, by earliest
+    // deadline, falling back to the order they were posted in.
+    enum class QueuedEventPriority : uint8_t {
+        Low,
+        Normal,
+        High,
+        Critical
+    };
+
+    using Deadline = std::chrono::steady_clock::time_point;
+    using Duration = std::chrono::steady_clock::duration;
+    using TimeToLive = Duration;
+    using QueuedEventTicket = uint64_t;
+
+    static constexpr Deadline noDeadline = Deadline::max();
+    static constexpr TimeToLive noTimeToLive = TimeToLive::max();
+    static constexpr std::size_t noEventLimit = std::numeric_limits<std::size_t>::max();
+
+    using EventHandler = InlineFunction<bool(EventID, const Object&),
+                                        BLACKBOARD_EVENT_HANDLER_CAPACITY>;
+    using CheckedEventHandler = InlineFunction<InvocationResult(EventID, const Object&),
+                                               BLACKBOARD_EVENT_HANDLER_CAPACITY>;
+    using ErrorHandler = InlineFunction<void(EventID, const Object&, DispatchResult),
+                                        BLACKBOARD_EVENT_HANDLER_CAPACITY>;
+    using SharedObject = std::shared_ptr<const Object>;
+    using EventContentSpan = Span<const Object* const>;
+
+    struct QueuedEventsReport {
+        std::size_t processedEvents = 0;
+        std::size_t failedEvents = 0;
+        std::size_t missedDeadlines = 0;
+        std::size_t cancelledEvents = 0;
+        std::size_t expiredEvents = 0;
+        std::size_t remainingEvents = 0;
+        DispatchResult firstFailure = DispatchResult::Success;
+        Event firstFailedEvent;
+        const Object* firstFailedEventContent = nullptr;
+    };
+
+    struct DeadLetter {
+        Event event;
+        Object eventContent;
+        std::chrono::steady_clock::time_point timestamp;
+        std::thread::id threadIdPostedBy;
+    };
+
+    // Decides whether an event is passed to a handler before the handler is invoked. A rate limit
+    // admits events as long as its token bucket, refilled at `eventsPerSecond` up to `burst`
+    // tokens, is not empty. A leading debounce admits only events that follow a quiet period,
+    // while a trailing debounce holds a copy of the latest event until a quiet period has passed,
+    // and passes it to the handler from the next ProcessQueuedEvents() call after that.
+    struct InvocationPolicy {
+        enum class Kind : uint8_t {
+            RateLimit,
+            LeadingDebounce,
+            TrailingDebounce
+        };
+
+        static InvocationPolicy RateLimit(double eventsPerSecond, double burst = 1.0);
+        static InvocationPolicy LeadingDebounce(Duration quietPeriod);
+        static InvocationPolicy TrailingDebounce(Duration quietPeriod);
+
+        Kind kind;
+        double eventsPerSecond;
+        double burst;
+        Duration quietPeriod;
+    };
+
     //----------------------------------------------------------------------------------------------
 
     Blackboard();
@@ -39,20 +145,271 @@ public:
     Blackboard(Blackboard&) = delete;
     Blackboard& operator=(const Blackboard&) = delete;
 
+    // Handlers are invoked in order of descending priority and, among equal priorities, in the
+    // order they were added.
     EventHandlerUniqueId AddEventHandler(EventID eventId, const EventHandler& eventHandler,
-                                         CallEventHandlerOnce callOnce);
+                                         CallEventHandlerOnce callOnce,
+                                         EventHandlerPriority priority = 0,
+                                         ParallelSafe parallelSafe = ParallelSafe::No);
+    EventHandlerUniqueId AddEventHandler(EventID eventId, EventHandler&& eventHandler,
+                                         CallEventHandlerOnce callOnce,
+                                         EventHandlerPriority priority = 0,
+                                         ParallelSafe parallelSafe = ParallelSafe::No);
+
+    // Constructs the handler directly from `callable`, which may return either `bool` or
+    // `InvocationResult` and is stored inline whenever it fits in BLACKBOARD_EVENT_HANDLER_CAPACITY
+    // bytes.
+    template <typename Callable,
+              typename = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, EventHandler>>>
+    EventHandlerUniqueId AddEventHandler(EventID eventId, Callable&& callable,
+                                         CallEventHandlerOnce callOnce,
+                                         EventHandlerPriority priority = 0,
+                                         ParallelSafe parallelSafe = ParallelSafe::No) {
+        auto eventHandler = MakeEventHandlerInvoker(std::forward<Callable>(callable));
+        return AddEventHandlerInternal(eventId,
+                                       EventHandlerContainer(std::move(eventHandler), callOnce,
+                                                             parallelSafe),
+                                       priority);
+    }
+
+    template <typename Callable>
+    EventHandlerUniqueId AddEventHandler(EventID eventId, Callable&& callable,
+                                         CallEventHandlerOnce callOnce,
+                                         const InvocationPolicy& invocationPolicy,
+                                         EventHandlerPriority priority = 0) {
+        EventHandlerContainer eventHandlerContainer(
+                MakeEventHandlerInvoker(std::forward<Callable>(callable)), callOnce,
+                ParallelSafe::No);
+        eventHandlerContainer.invocationPolicyState =
+                std::make_unique<InvocationPolicyState>(invocationPolicy);
+        return AddEventHandlerInternal(eventId, std::move(eventHandlerContainer), priority);
+    }
+
+    template <auto MemberFunction, typename Class>
+    EventHandlerUniqueId AddEventHandler(EventID eventId, Class* instance,
+                                         CallEventHandlerOnce callOnce,
+                                         EventHandlerPriority priority = 0,
+                                         ParallelSafe parallelSafe = ParallelSafe::No) {
+        return AddEventHandler(eventId, [instance](EventID eventId, const Object& eventContent) {
+            return std::invoke(MemberFunction, instance, eventId, eventContent);
+        }, callOnce, priority, parallelSafe);
+    }
+
+    template <auto Function>
+    EventHandlerUniqueId AddEventHandler(EventID eventId, CallEventHandlerOnce callOnce,
+                                         EventHandlerPriority priority = 0,
+                                         ParallelSafe parallelSafe = ParallelSafe::No) {
+        return AddEventHandler(eventId, [](EventID eventId, const Object& eventContent) {
+            return std::invoke(Function, eventId, eventContent);
+        }, callOnce, priority, parallelSafe);
+    }
+
+    // Async handlers are invoked on the executor after the posting thread has moved on, and share
+    // a single copy of the payload, which lives as long as any of them holds it. They may return
+    // either `bool` or `InvocationResult`, although only errors have any effect and are reported to
+    // the error handler by ProcessQueuedEvents() or WaitForAsyncEventHandlers().
+    template <typename Callable>
+    EventHandlerUniqueId AddAsyncEventHandler(EventID eventId, Callable&& callable,
+                                              CallEventHandlerOnce callOnce,
+                                              EventHandlerPriority priority = 0) {
+        auto eventHandler = MakeAsyncEventHandlerInvoker(std::forward<Callable>(callable));
+        return AddEventHandlerInternal(eventId,
+                                       EventHandlerContainer(std::move(eventHandler), callOnce,
+                                                             ParallelSafe::No,
+                                                             EventHandlerKind::Async),
+                                       priority);
+    }
+
+    // Batch handlers receive the payloads of consecutive queued events with the same ID in a
+    // single call, once a different event is about to be processed or processing stops, and after
+    // the regular handlers of those events have been invoked. Events posted without queueing are
+    // passed as batches of one, in order of priority along with the regular handlers. Queued events
+    // stopped by a regular handler are left out of the batches.
+    template <typename Callable>
+    EventHandlerUniqueId AddBatchEventHandler(EventID eventId, Callable&& callable,
+                                              CallEventHandlerOnce callOnce,
+                                              EventHandlerPriority priority = 0) {
+        auto eventHandler = MakeBatchEventHandlerInvoker(std::forward<Callable>(callable));
+        return AddBatchEventHandlerInternal(eventId,
+                                            EventHandlerContainer(std::move(eventHandler),
+                                                                  callOnce, ParallelSafe::No,
+                                                                  EventHandlerKind::Batch),
+                                            priority);
+    }
+
+    // Field change handlers are invoked with the payload and the changes of the values at
+    // `keyPaths` since the previous event, only if any of them has changed. The handler keeps a
+    // copy of just those values, which it compares the payload against and patches with the
+    // changes, so the first event carrying them is always a change. One-time handlers are removed
+    // after the first change.
+    template <typename Callable>
+    EventHandlerUniqueId AddFieldChangeHandler(EventID eventId,
+                                               const std::vector<KeyPath>& keyPaths,
+                                               Callable&& callable, CallEventHandlerOnce callOnce,
+                                               EventHandlerPriority priority = 0) {
+        // Shared, since handlers are copied on every invocation.
+        auto fieldChangeHandler = std::make_shared<FieldChangeHandler<std::decay_t<Callable>>>(
+                FieldChangeHandler<std::decay_t<Callable>>{
+                        Event(eventId), keyPaths, Object(), std::forward<Callable>(callable),
+                        callOnce == CallEventHandlerOnce::Yes, false, 0});
+
+        fieldChangeHandler->eventHandlerId = AddEventHandler(eventId,
+                [this, fieldChangeHandler](EventID eventId, const Object& eventContent) {
+            auto& handler = *fieldChangeHandler;
+            if (handler.callOnce && handler.invoked) {
+                return InvocationResult::Continue;
+            }
+            const auto delta = handler.fields.Diff(eventContent, handler.keyPaths);
+            if (delta.empty()) {
+                return InvocationResult::Continue;
+            }
+            handler.fields.Patch(delta);
+            handler.invoked = true;
+            // Handlers invoked by the replay of retained events do not know their ID yet.
+            if (handler.callOnce && handler.eventHandlerId != 0) {
+                RemoveEventHandler(handler.event, handler.eventHandlerId);
+            }
+            return InvokeEventHandler(handler.callable, eventId, eventContent, delta);
+        }, CallEventHandlerOnce::No, priority);
+
+        if (fieldChangeHandler->callOnce && fieldChangeHandler->invoked && HasHandlers(eventId)) {
+            RemoveEventHandler(eventId, fieldChangeHandler->eventHandlerId);
+        }
+        return fieldChangeHandler->eventHandlerId;
+    }
+
     void RemoveEventHandler(EventID eventId, EventHandlerUniqueId eventHandlerId);
     void ClearEventHandlers(EventID eventId);
 
+    // Handlers of typed channels receive only the payload, as `const T&`, and may return either
+    // `bool` or `InvocationResult`.
+    template <typename T, typename Callable>
+    EventHandlerUniqueId AddEventHandler(Channel<T> channel, Callable&& callable,
+                                         CallEventHandlerOnce callOnce,
+                                         EventHandlerPriority priority = 0,
+                                         ParallelSafe parallelSafe = ParallelSafe::No) {
+        auto eventHandler = MakeChannelHandlerInvoker<T>(std::forward<Callable>(callable));
+        return AddChannelHandler(channel.id, &channelTypeTag<T>,
+                                 EventHandlerContainer(std::move(eventHandler), callOnce,
+                                                       parallelSafe),
+                                 priority);
+    }
+
+    template <typename T>
+    void RemoveEventHandler(Channel<T> channel, EventHandlerUniqueId eventHandlerId) {
+        RemoveChannelHandler(channel.id, eventHandlerId);
+    }
+
+    template <typename T>
+    void ClearEventHandlers(Channel<T> channel) {
+        ClearChannelHandlers(channel.id);
+    }
+
+    template <typename T>
+    void PostEvent(Channel<T> channel, const T& eventContent) {
+        PostChannelEvent(channel.id, &channelTypeTag<T>, &eventContent);
+    }
+
+    // Returns whether posting the event would invoke any handler. Most events without handlers are
+    // rejected by a lock-free filter, without searching the registered events.
+    bool HasHandlers(EventID eventId);
+
+    template <typename T>
+    bool HasHandlers(Channel<T> channel) {
+        return HasChannelHandlers(channel.id);
+    }
+
+    // Build the payload by invoking `eventContentFactory` only if the event has handlers, or if it
+    // has to be captured as a dead letter or retained.
+    template <typename EventContentFactory,
+              typename = std::enable_if_t<std::is_invocable_r_v<Object, EventContentFactory&>>>
+    void PostEvent(EventID eventId, EventContentFactory&& eventContentFactory) {
+        if (HasHandlers(eventId) || deadLettersEnabled.load(std::memory_order_relaxed) ||
+                retainedEventCount.load(std::memory_order_relaxed) != 0) {
+            PostEvent(eventId, Object(eventContentFactory()));
+        }
+    }
+
+    template <typename EventContentFactory,
+              typename = std::enable_if_t<std::is_invocable_r_v<Object, EventContentFactory&>>>
+    DispatchResult TryPostEvent(EventID eventId, EventContentFactory&& eventContentFactory) {
+        if (HasHandlers(eventId) || deadLettersEnabled.load(std::memory_order_relaxed) ||
+                retainedEventCount.load(std::memory_order_relaxed) != 0) {
+            return TryPostEvent(eventId, Object(eventContentFactory()));
+        }
+        return DispatchResult::Success;
+    }
+
+    template <typename T, typename EventContentFactory,
+              typename = std::enable_if_t<std::is_invocable_r_v<T, EventContentFactory&>>>
+    void PostEvent(Channel<T> channel, EventContentFactory&& eventContentFactory) {
+        if (HasHandlers(channel)) {
+            PostEvent(channel, static_cast<const T&>(eventContentFactory()));
+        }
+    }
+
+    // When built without exceptions, the throwing functions below report failures only through the
+    // error handler.
     void PostEvent(EventID eventId, const Object& eventContent);
     void PostEventRequiringHandler(EventID eventId, const Object& eventContent);
     void PostException(EventID eventId, const Object& eventContent);
 
-    void PostQueuedEvent(EventID eventId, const Object& eventContent);
-    void PostQueuedEventRequiringHandler(EventID eventId, const Object& eventContent);
-    void PostQueuedException(EventID eventId, const Object& eventContent);
+    // Events processed after their deadline are still dispatched, but are reported to the error
+    // handler as DeadlineMissed, which is never thrown. Events that outlive their time to live, on
+    // the other hand, are skipped silently, the same way cancelled ones are.
+    QueuedEventTicket PostQueuedEvent(EventID eventId, const Object& eventContent,
+                                      QueuedEventPriority priority = QueuedEventPriority::Normal,
+                                      Deadline deadline = noDeadline,
+                                      TimeToLive timeToLive = noTimeToLive);
+    QueuedEventTicket PostQueuedEventRequiringHandler(
+            EventID eventId, const Object& eventContent,
+            QueuedEventPriority priority = QueuedEventPriority::Normal,
+            Deadline deadline = noDeadline, TimeToLive timeToLive = noTimeToLive);
+    QueuedEventTicket PostQueuedException(EventID eventId, const Object& eventContent);
     void ProcessQueuedEvents();
 
+    // Stops once `maxDuration` has elapsed or `maxEvents` have been dispatched, whichever comes
+    // first. The events left behind stay ahead of the ones posted later, unless those have a higher
+    // priority or an earlier deadline, and are counted in QueuedEventsReport::remainingEvents.
+    QueuedEventsReport ProcessQueuedEvents(Duration maxDuration,
+                                           std::size_t maxEvents = noEventLimit);
+
+    // Cancelling an event that has already been processed, or a ticket that has not been issued,
+    // has no effect.
+    void CancelQueuedEvent(QueuedEventTicket ticket);
+
+    // Non-throwing counterparts, which return failures instead and, unlike ProcessQueuedEvents(),
+    // keep processing queued events after a failure.
+    DispatchResult TryPostEvent(EventID eventId, const Object& eventContent);
+    DispatchResult TryPostEventRequiringHandler(EventID eventId, const Object& eventContent);
+    QueuedEventsReport TryProcessQueuedEvents();
+    QueuedEventsReport TryProcessQueuedEvents(Duration maxDuration,
+                                              std::size_t maxEvents = noEventLimit);
+
+    void SetErrorHandler(const ErrorHandler& errorHandler);
+
+    // Async handlers are invoked on a built-in work-stealing thread pool, unless an executor is
+    // set. The executor must outlive the blackboard, or be replaced while no async handler is
+    // pending.
+    void SetExecutor(Executor* executor);
+    void WaitForAsyncEventHandlers();
+    std::size_t GetPendingAsyncEventHandlerCount();
+
+    // Captures a copy of every event posted while it has no handlers into a ring of `capacity` dead
+    // letters, which overwrites the oldest ones once full. A capacity of zero disables capturing.
+    void EnableDeadLetters(std::size_t capacity);
+    std::vector<DeadLetter> DrainDeadLetters();
+    std::vector<DeadLetter> PeekDeadLetters();
+    std::size_t GetOverwrittenDeadLetterCount();
+
+    // Retains copies of the last `count` payloads posted to an event, whether it has handlers or
+    // not, and replays them from the oldest to the newest to every handler added to it afterwards,
+    // while one-time handlers receive only the newest one. The payloads are kept in a ring whose
+    // slots are reused in place. A count of zero stops retaining the event. Typed channels are not
+    // retained.
+    void RetainEvents(EventID eventId, std::size_t count);
+    std::vector<Object> PeekRetainedEvents(EventID eventId);
+
     void StopInvocationLoop();
 
     //----------------------------------------------------------------------------------------------
@@ -89,6 +446,65 @@ public:
     //----------------------------------------------------------------------------------------------
 
 private:
+    // Receives either an Object or the payload of a typed channel, depending on the event.
+    using EventHandlerInvoker = InlineFunction<InvocationResult(EventID, const void*),
+                                               sizeof(EventHandler)>;
+
+    template <typename Callable, typename... Arguments>
+    static InvocationResult InvokeEventHandler(Callable& callable, Arguments&&... arguments) {
+        if constexpr (std::is_invocable_r_v<InvocationResult, Callable&, Arguments...>) {
+            return callable(std::forward<Arguments>(arguments)...);
+        } else {
+            static_assert(std::is_invocable_r_v<bool, Callable&, Arguments...>,
+                          "Event handlers must return either bool or InvocationResult!");
+            return callable(std::forward<Arguments>(arguments)...) ? InvocationResult::Continue
+                                                                   : InvocationResult::Stop;
+        }
+    }
+
+    template <typename Callable>
+    static EventHandlerInvoker MakeEventHandlerInvoker(Callable&& callable) {
+        return EventHandlerInvoker(
+            [callable = std::decay_t<Callable>(std::forward<Callable>(callable))]
+            (EventID eventId, const void* eventContent) mutable {
+                return InvokeEventHandler(callable, eventId,
+                                          *static_cast<const Object*>(eventContent));
+            });
+    }
+
+    // Async handlers receive a pointer to the shared payload, instead of the payload itself.
+    template <typename Callable>
+    static EventHandlerInvoker MakeAsyncEventHandlerInvoker(Callable&& callable) {
+        return EventHandlerInvoker(
+            [callable = std::decay_t<Callable>(std::forward<Callable>(callable))]
+            (EventID eventId, const void* eventContent) mutable {
+                return InvokeEventHandler(callable, eventId,
+                                          *static_cast<const SharedObject*>(eventContent));
+            });
+    }
+
+    // Batch handlers receive a pointer to the span of payloads, instead of a single payload.
+    template <typename Callable>
+    static EventHandlerInvoker MakeBatchEventHandlerInvoker(Callable&& callable) {
+        return EventHandlerInvoker(
+            [callable = std::decay_t<Callable>(std::forward<Callable>(callable))]
+            (EventID eventId, const void* eventContents) mutable {
+                return InvokeEventHandler(callable, eventId,
+                                          *static_cast<const EventContentSpan*>(eventContents));
+            });
+    }
+
+    template <typename T, typename Callable>
+    static EventHandlerInvoker MakeChannelHandlerInvoker(Callable&& callable) {
+        return EventHandlerInvoker(
+            [callable = std::decay_t<Callable>(std::forward<Callable>(callable))]
+            (EventID, const void* eventContent) mutable {
+                return InvokeEventHandler(callable, *static_cast<const T*>(eventContent));
+            });
+    }
+
+    //----------------------------------------------------------------------------------------------
+
     struct QueuedEvent {
         enum class RequiresHandler : bool {
             No,
@@ -100,31 +516,85 @@ private:
             Yes
         };
 
-        QueuedEvent(EventID event, const Object& eventContent, RequiresHandler requiresHandler,
-                    IsException isException);
+        QueuedEvent(EventID event, const Object& eventContent, SharedObject ownedEventContent,
+                    RequiresHandler requiresHandler, IsException isException,
+                    QueuedEventPriority priority, Deadline deadline, Deadline expiry,
+                    uint64_t sequence);
+        QueuedEvent(QueuedEvent&& from) noexcept;
+        QueuedEvent& operator=(QueuedEvent&& from) noexcept;
         ~QueuedEvent();
 
         QueuedEvent(const QueuedEvent& from) = delete;
         QueuedEvent& operator=(const QueuedEvent& from) = delete;
 
+        // Orders the heap of queued events, so that the next event to be processed is on top.
+        static bool IsScheduledAfter(const QueuedEvent& first, const QueuedEvent& second);
+
         Event event;
-        const Object& eventContent;
+        const Object* eventContent;
+        // Set only if the payload has been copied, rather than being kept alive by the caller.
+        SharedObject ownedEventContent;
+        std::thread::id threadIdPostedBy;
+        Deadline deadline;
+        Deadline expiry;
+        uint64_t sequence;
+        uint32_t cancellationSlot;
+        QueuedEventPriority priority;
         bool requiresHandler;
         bool isException;
     };
 
     //----------------------------------------------------------------------------------------------
 
+    enum class EventHandlerKind : uint8_t {
+        Regular,
+        Async,
+        Batch
+    };
+
+    // Selects the handlers invoked by ProcessEvent(), since queued events are passed to their
+    // batch handlers separately.
+    enum class DispatchMode : uint8_t {
+        Immediate,
+        Queued,
+        Batch
+    };
+
+    // Touched only by the thread dispatching the event, so it is never locked.
+    struct InvocationPolicyState {
+        explicit InvocationPolicyState(const InvocationPolicy& invocationPolicy);
+
+        // Returns whether the event is to be passed to the handler now.
+        bool AdmitEvent(const Object& eventContent, Deadline now);
+
+        InvocationPolicy invocationPolicy;
+        double tokens;
+        Deadline lastRefill;
+        Deadline lastEvent;
+
+        Object pendingEventContent;
+        Deadline pendingUntil;
+        bool pending;
+    };
+
     struct EventHandlerContainer {
-        EventHandlerContainer(const EventHandler& eventHandler, CallEventHandlerOnce callOnce);
+        EventHandlerContainer(EventHandlerInvoker&& eventHandler, CallEventHandlerOnce callOnce,
+                              ParallelSafe parallelSafe,
+                              EventHandlerKind kind = EventHandlerKind::Regular);
+        EventHandlerContainer(EventHandlerContainer&& from) noexcept;
         ~EventHandlerContainer();
 
         bool callOnce;
+        bool parallelSafe;
+        EventHandlerKind kind;
         EventHandlerUniqueId eventHandlerId;
-        EventHandler eventHandler;
+        EventHandlerInvoker eventHandler;
+        std::unique_ptr<InvocationPolicyState> invocationPolicyState;
     };
 
-    using EventHandlerList = std::list<EventHandlerContainer>;
+    // Kept sorted by priority, so that dispatching never has to sort handlers.
+    using EventHandlerList = std::multimap<EventHandlerPriority, EventHandlerContainer,
+                                           std::greater<>>;
 
     //----------------------------------------------------------------------------------------------
 
@@ -141,29 +611,138 @@ private:
         std::mutex eventMutex;
         std::condition_variable eventCondition;
 
+        const void* channelType;
+        bool hasBatchEventHandlers;
         bool deleted;
     };
 
     //----------------------------------------------------------------------------------------------
 
+    struct FailedAsyncEventHandler {
+        Event event;
+        SharedObject eventContent;
+    };
+
+    template <typename Callable>
+    struct FieldChangeHandler {
+        Event event;
+        std::vector<KeyPath> keyPaths;
+        Object fields;
+        Callable callable;
+        bool callOnce;
+        bool invoked;
+        EventHandlerUniqueId eventHandlerId;
+    };
+
+    struct DebouncedEventHandler {
+        Event event;
+        EventHandlerUniqueId eventHandlerId;
+    };
+
+    //----------------------------------------------------------------------------------------------
+
     using Events = std::map<Event, EventContainer, std::less<>>;
-    using QueuedEvents = std::queue<QueuedEvent>;
-
-    void PostEventInternal(EventID eventId, const Object& eventContent, bool requiresHandler);
-    void PostQueuedEventInternal(EventID eventId,
-                                 const Object& eventContent,
-                                 QueuedEvent::RequiresHandler requiresHandler,
-                                 QueuedEvent::IsException isException);
-    void ProcessEvent(Events::iterator eventPair, const Object& eventContent);
-
-    EventHandlerUniqueId CreateEvent(EventID eventId, const EventHandler& eventHandler,
-                                     CallEventHandlerOnce callOnce);
-    bool TryToRemoveEvent(Events::iterator& eventPair);
-    void CheckIfEventNeedsRemoval(Events::iterator& eventPair);
+    using Channels = std::unordered_map<ChannelID, EventContainer>;
+    using QueuedEvents = std::vector<QueuedEvent>;
+    using DeadLetters = RingBuffer<DeadLetter>;
+    using RetainedEvents = std::map<Event, RingBuffer<Object>, std::less<>>;
+
+    enum class StopOnFailure : bool {
+        No,
+        Yes
+    };
+
+    EventHandlerUniqueId AddEventHandlerInternal(EventID eventId,
+                                                 EventHandlerContainer&& eventHandlerContainer,
+                                                 EventHandlerPriority priority);
+    EventHandlerUniqueId AddBatchEventHandlerInternal(EventID eventId,
+                                                      EventHandlerContainer&& eventHandlerContainer,
+                                                      EventHandlerPriority priority);
+    EventHandlerUniqueId AddChannelHandler(ChannelID channelId, const void* channelType,
+                                           EventHandlerContainer&& eventHandlerContainer,
+                                           EventHandlerPriority priority);
+    void RemoveChannelHandler(ChannelID channelId, EventHandlerUniqueId eventHandlerId);
+    void ClearChannelHandlers(ChannelID channelId);
+    void PostChannelEvent(ChannelID channelId, const void* channelType,
+                          const void* eventContent);
+    bool HasChannelHandlers(ChannelID channelId);
+
+    template <typename EventMap, typename EventKey>
+    EventHandlerUniqueId AddEventHandlerInternal(EventMap& eventMap, EventKey eventKey,
+                                                 EventHandlerContainer&& eventHandlerContainer,
+                                                 EventHandlerPriority priority);
+    template <typename EventMap, typename EventKey>
+    void RemoveEventHandlerInternal(EventMap& eventMap, EventKey eventKey,
+                                    EventHandlerUniqueId eventHandlerId);
+    template <typename EventMap, typename EventKey>
+    void ClearEventHandlersInternal(EventMap& eventMap, EventKey eventKey);
+
+    DispatchResult PostEventInternal(EventID eventId, const Object& eventContent,
+                                     bool requiresHandler);
+    QueuedEventTicket PostQueuedEventInternal(EventID eventId,
+                                              const Object& eventContent,
+                                              SharedObject ownedEventContent,
+                                              QueuedEvent::RequiresHandler requiresHandler,
+                                              QueuedEvent::IsException isException,
+                                              QueuedEventPriority priority,
+                                              Deadline deadline,
+                                              TimeToLive timeToLive);
+    // Must be called with processingQueuedEventsMutex locked.
+    void ReleaseCancellationSlots();
+    bool CheckIfQueuedEventIsWithdrawn(const QueuedEvent& queuedEvent,
+                                       QueuedEventsReport* queuedEventsReport);
+    QueuedEventsReport ProcessQueuedEventsInternal(StopOnFailure stopOnFailure,
+                                                   Duration maxDuration, std::size_t maxEvents);
+    DispatchResult DispatchQueuedEvent(const QueuedEvent& queuedEvent, bool* isBatched);
+    DispatchResult DispatchQueuedEventBatch(const Event& event,
+                                            const std::vector<const Object*>& eventContents);
+    template <typename EventMap>
+    InvocationResult DispatchEvent(EventMap& eventMap, typename EventMap::iterator eventPair,
+                                   const void* eventContent);
+    template <typename EventMap>
+    InvocationResult ProcessEvent(EventMap& eventMap, typename EventMap::iterator eventPair,
+                                  const void* eventContent, DispatchMode dispatchMode);
+    InvocationResult InvokeParallelEventHandlers(EventHandlerList& eventHandlerList,
+                                                 EventHandlerList::iterator* currentEventHandler,
+                                                 EventID eventId, const void* eventContent);
+    static InvocationResult InvokeStoppableEventHandler(const EventHandlerInvoker& eventHandler,
+                                                        EventID eventId,
+                                                        const void* eventContent);
+    void ExecuteAsyncEventHandler(const EventHandlerInvoker& eventHandler, EventID eventId,
+                                  const SharedObject& eventContent);
+    void CompleteAsyncEventHandler(Event&& event, SharedObject&& eventContent,
+                                   InvocationResult invocationResult);
+    void ReportAsyncEventHandlerFailures();
+    void CreateThreadPool();
+    Executor& GetExecutor();
+
+    void CaptureDeadLetter(EventID eventId, const Object& eventContent,
+                           std::thread::id threadIdPostedBy);
+    void RetainEvent(EventID eventId, const Object& eventContent);
+    void ReplayRetainedEvents(EventID eventId, EventHandlerUniqueId eventHandlerId);
+    DispatchResult ReportFailure(EventID eventId, const Object& eventContent,
+                                 DispatchResult failure);
+    void ThrowOnFailure(EventID eventId, const Object& eventContent,
+                        DispatchResult failure) const;
+
+    template <typename EventMap, typename EventKey>
+    EventHandlerUniqueId CreateEvent(EventMap& eventMap, EventKey eventKey,
+                                     EventHandlerContainer&& eventHandlerContainer,
+                                     EventHandlerPriority priority);
+    EventHandlerUniqueId InsertEventHandler(EventHandlerList& eventHandlerList,
+                                            EventHandlerContainer&& eventHandlerContainer,
+                                            EventHandlerPriority priority);
+    template <typename EventMap>
+    bool TryToRemoveEvent(EventMap& eventMap, typename EventMap::iterator& eventPair);
+    template <typename EventMap>
+    void CheckIfEventNeedsRemoval(EventMap& eventMap, typename EventMap::iterator& eventPair);
     void CheckIfHandlerNeedsRemoval(EventHandlerList& eventHandlerList,
                                     EventHandlerList::iterator* currentEventHandler);
+    bool AdmitEvent(EventID eventId, EventHandlerContainer& eventHandlerContainer,
+                    const void* eventContent);
+    void DispatchDebouncedEvents(QueuedEventsReport* queuedEventsReport);
 
-    EventHandlerUniqueId CalculateEventHandlerId(const EventHandler& eventHandler) const;
+    EventHandlerUniqueId CalculateEventHandlerId(const EventHandlerInvoker& eventHandler) const;
     std::thread::id GetThisThreadId() const;
 
     void IncrementEventsUnderProcessingSemaphore();
@@ -173,16 +752,40 @@ private:
 
     std::thread::id owner;
     Events events;
+    Channels channels;
+    EventFilter eventFilter;
 
     QueuedEvents queuedEventsFirst;
     QueuedEvents queuedEventsSecond;
     QueuedEvents* currentQueuedEvents;
     QueuedEvents* nextQueuedEvents;
+    uint64_t nextQueuedEventSequence;
+
+    // Tickets refer to the slots of queued events, along with their generation, so that a slot is
+    // reused once its event has been popped without any later ticket cancelling it. Guarded by
+    // processingQueuedEventsMutex, although the count is read without locking, so that the drain
+    // looks cancellations up only if there are any.
+    struct CancellationSlot {
+        uint32_t generation;
+        bool queued;
+        bool cancelled;
+    };
+
+    std::vector<CancellationSlot> cancellationSlots;
+    std::vector<uint32_t> freeCancellationSlots;
+    std::atomic<std::size_t> cancelledQueuedEventCount;
 
     bool processingQueuedEvents;
     std::thread::id threadIdProcessingQueuedEvents;
     std::mutex processingQueuedEventsMutex;
     std::condition_variable processingQueuedEventsCondition;
+    // Slots of the events popped by the drain, which are released in bulk, so that popping an event
+    // does not lock unless any event is cancelled. Touched only by the thread processing queued
+    // events.
+    std::vector<uint32_t> poppedCancellationSlots;
+    // Copied payloads of processed events, which are kept until the next drain, since batches and
+    // reports point to them. Touched only by the thread processing queued events.
+    std::vector<SharedObject> processedEventContents;
 
     int64_t eventsUnderProcessingSemaphore;
     std::mutex eventsUnderProcessingSemaphoreMutex;
@@ -190,6 +793,30 @@ private:
     EventHandlerUniqueId currentlyInvokedHandlerId;
     bool currentlyInvokedHandlerAutoRemoved;
     bool currentlyInvokedHandlerRemovedItself;
+
+    ErrorHandler errorHandler;
+
+    std::unique_ptr<DeadLetters> deadLetters;
+    std::size_t overwrittenDeadLetters;
+    std::atomic<bool> deadLettersEnabled;
+    std::mutex deadLettersMutex;
+
+    // Counts the retained events, so that posting looks them up only if there are any.
+    RetainedEvents retainedEvents;
+    std::atomic<std::size_t> retainedEventCount;
+    std::mutex retainedEventsMutex;
+
+    std::once_flag threadPoolCreated;
+    std::unique_ptr<ThreadPool> threadPool;
+    Executor* executor;
+
+    std::size_t pendingAsyncEventHandlers;
+    std::vector<FailedAsyncEventHandler> failedAsyncEventHandlers;
+    std::mutex asyncEventHandlersMutex;
+    std::condition_variable asyncEventHandlersCondition;
+
+    std::vector<DebouncedEventHandler> debouncedEventHandlers;
+    std::mutex debouncedEventHandlersMutex;
 };
 
 } // namespace blackboard
@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/Object.h"
+#include "Blackboard/Value.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace blackboard {
+
+// Versioned store of entries keyed by values, which keeps the previous versions of every entry for
+// as long as there are snapshots that may read them (MVCC). Writers are serialized with each other
+// but never block readers, which read from immutable snapshots without locking. Versions that no
+// snapshot can read any more are reclaimed by the writers, based on the oldest version pinned by
+// the active snapshots, which act as the epochs of the reclamation scheme. Removed keys are
+// reclaimed the same way, once no snapshot can read any of their versions. Snapshots beyond
+// maxSnapshots pin their versions under a mutex instead, which they share only with each other and
+// with the reclamation.
+//
+// If created with a blackboard, every write posts a change event carrying the "Key", "Version",
+// "Deleted" and, unless deleted, the "Entry", which is built only if the event has handlers. It is
+// posted once the write has been committed and the store unlocked, so that its handlers may write
+// to the store as well.
+//
+// Entries may be indexed by the values of their fields, either by hash, for lookups of a value, or
+// in order, for range queries as well. Indexes are maintained by the writers and reflect the latest
+// version, so queries lock out the writers while they run, and return keys whose entries should be
+// read through a snapshot taken afterwards.
+//
+class BoardStore final {
+public:
+    using Version = std::uint64_t;
+
+    enum class IndexKind : uint8_t {
+        Hash,
+        Ordered
+    };
+
+    // The bucket table is allocated up front and never grows, while Snapshot::ForEach() walks all
+    // of its buckets, so stores expected to hold far more entries than the default should be
+    // created with a bucket count close to their size.
+    static constexpr std::size_t defaultBucketCount = 1 << 10;
+    static constexpr std::size_t maxSnapshots = 64;
+
+private:
+    struct EntryVersion {
+        Version version;
+        bool deleted;
+        Object entry;
+        std::atomic<EntryVersion*> older;
+    };
+
+    struct KeyNode {
+        Value key;
+        std::atomic<EntryVersion*> newest;
+        std::atomic<KeyNode*> next;
+    };
+
+public:
+    // Consistent, immutable view of the store as of a version, whose entries remain valid for as
+    // long as the snapshot exists.
+    class Snapshot {
+    public:
+        Snapshot(Snapshot&& from) noexcept;
+        ~Snapshot();
+
+        Snapshot(const Snapshot& from) = delete;
+        Snapshot& operator=(const Snapshot& from) = delete;
+        Snapshot& operator=(Snapshot&& from) = delete;
+
+        // Returns null for keys that do not exist or had been removed as of the snapshot.
+        const Object* Get(const Value& key) const;
+        Version GetVersion() const;
+
+        // Invokes `callable` with the key and the entry of every entry of the snapshot.
+        template <typename Callable>
+        void ForEach(Callable&& callable) const {
+            for (const auto& bucket : store->buckets) {
+                for (auto keyNode = bucket.load(std::memory_order_acquire); keyNode;
+                        keyNode = keyNode->next.load(std::memory_order_acquire)) {
+                    if (const auto entryVersion = GetVisibleVersion(*keyNode)) {
+                        callable(keyNode->key, entryVersion->entry);
+                    }
+                }
+            }
+        }
+
+    private:
+        friend class BoardStore;
+
+        Snapshot(const BoardStore& store, std::size_t snapshotSlot, Version version);
+
+        const EntryVersion* GetVisibleVersion(const KeyNode& keyNode) const;
+
+        const BoardStore* store;
+        std::size_t snapshotSlot;
+        Version version;
+    };
+
+    explicit BoardStore(std::size_t bucketCount = defaultBucketCount);
+    BoardStore(Blackboard& blackboard, Blackboard::EventID changeEventId,
+               std::size_t bucketCount = defaultBucketCount);
+    ~BoardStore();
+
+    BoardStore(const BoardStore& from) = delete;
+    BoardStore& operator=(const BoardStore& from) = delete;
+
+    // Both return the version of the write, while removing a missing entry writes nothing.
+    Version Put(const Value& key, const Object& entry);
+    Version Remove(const Value& key);
+
+    Snapshot GetSnapshot() const;
+    Version GetVersion() const;
+    // Number of superseded versions not reclaimed yet.
+    std::size_t GetRetainedVersionCount() const;
+    // Number of keys, including the removed ones not reclaimed yet.
+    std::size_t GetKeyCount() const;
+
+    // Indexes the existing and future entries that carry `field`, unless its value is an object or
+    // NaN. Ordered indexes hold only numbers and strings.
+    void AddIndex(const Value& field, IndexKind kind);
+    // Both return the keys in no particular order, and require an index of `field`.
+    std::vector<Value> FindKeys(const Value& field, const Value& value) const;
+    // Finds the keys whose values lie in [lower, upper), where a missing bound leaves the range
+    // open on that side, up to the values of another type. Requires an ordered index.
+    std::vector<Value> FindKeysInRange(const Value& field, const std::optional<Value>& lower,
+                                       const std::optional<Value>& upper) const;
+
+private:
+    struct RetiredVersion {
+        EntryVersion* superseded;
+        EntryVersion* superseding;
+    };
+
+    struct RetiredKey {
+        KeyNode* keyNode;
+        Version version;
+    };
+
+    using IndexedKeys = std::unordered_set<Value, ValueHash>;
+
+    struct Index {
+        Value field;
+        IndexKind kind;
+        std::unordered_map<Value, IndexedKeys, ValueHash> hashedKeys;
+        std::map<Value, IndexedKeys, ValueLess> orderedKeys;
+    };
+
+    Version Write(const Value& key, const Object* entry);
+    KeyNode* FindKeyNode(const Value& key) const;
+    std::size_t AcquireSnapshotSlot() const;
+    Version GetOldestPinnedVersion() const;
+    void ReclaimVersions();
+    void ReclaimKeys(Version oldestPinnedVersion);
+    void PostChange(const Value& key, Version version, const Object* entry);
+
+    const Index& GetIndex(const Value& field) const;
+    void UpdateIndexes(const Value& key, const Object* superseded, const Object* entry);
+    static void IndexKey(Index& index, const Value& value, const Value& key);
+    static void UnindexKey(Index& index, const Value& value, const Value& key);
+
+    std::vector<std::atomic<KeyNode*>> buckets;
+    std::size_t bucketMask;
+
+    std::atomic<Version> committedVersion;
+    // Versions pinned by the active snapshots, plus one, or 0 for free slots.
+    mutable std::array<std::atomic<Version>, maxSnapshots> snapshotVersions;
+    // Versions pinned by the snapshots that found no free slot.
+    mutable std::mutex overflowSnapshotsMutex;
+    mutable std::multiset<Version> overflowSnapshotVersions;
+
+    mutable std::mutex writerMutex;
+    std::deque<RetiredVersion> retiredVersions;
+    // Keys by the version that removed them, which are unlinked once no snapshot reads an older
+    // one, and then by the first version that cannot reach them, which they are deleted after.
+    std::deque<RetiredKey> removedKeys;
+    std::deque<RetiredKey> unlinkedKeys;
+    std::size_t keyCount;
+    std::vector<Index> indexes;
+
+    Blackboard* blackboard;
+    std::string changeEventId;
+};
+
+} // namespace blackboard
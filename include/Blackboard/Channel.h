@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace blackboard {
+
+using ChannelID = std::uint64_t;
+
+// 64-bit FNV-1a hash, so that channel IDs can be computed at compile time.
+constexpr ChannelID HashChannelName(std::string_view channelName) {
+    ChannelID hash = 0xcbf29ce484222325;
+    for (const auto character : channelName) {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+// Event channel carrying payloads of type `T`, which are delivered to handlers as `const T&`
+// without being converted to an Object.
+//
+template <typename T>
+struct Channel {
+    constexpr explicit Channel(ChannelID id) : id(id) {}
+    constexpr explicit Channel(std::string_view channelName) : id(HashChannelName(channelName)) {}
+
+    ChannelID id;
+};
+
+// Its address identifies the payload type of a channel, in order to detect channels that are used
+// with more than one type.
+template <typename T>
+inline constexpr char channelTypeTag = 0;
+
+inline namespace literals {
+
+constexpr ChannelID operator""_evt(const char* channelName, std::size_t length) {
+    return HashChannelName(std::string_view(channelName, length));
+}
+
+} // namespace literals
+
+} // namespace blackboard
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/InlineFunction.h"
+#include "Blackboard/Value.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace blackboard {
+
+class DerivedValues;
+
+// Reads the values a computation depends on, recording each of them as a dependency.
+class DerivedValueReader {
+public:
+    Value Get(std::string_view name);
+
+private:
+    friend class DerivedValues;
+
+    DerivedValueReader(DerivedValues& derivedValues, std::vector<std::size_t>& dependencies);
+
+    DerivedValues* derivedValues;
+    std::vector<std::size_t>* dependencies;
+};
+
+// Named values that are either inputs, set directly or from a field of the payloads of an event,
+// or derived from other values by a computation. The dependencies of a computation are the values
+// it reads through its DerivedValueReader, which are recorded anew every time it runs, so they may
+// differ between runs.
+//
+// Derived values are computed lazily, only when read, and only if any of the values they depend on
+// has changed since they were last computed, which is checked by bringing those up to date first,
+// in topological order. A result that is equal to the previous one does not count as a change, so
+// it cuts the recomputation of the values that depend on it off. Observed values are the only ones
+// brought up to date eagerly, after every change of an input, in order of their depth, and their
+// observers are invoked only if they have changed.
+//
+// Computations must not depend on their own results, and must not change the values themselves.
+// Must be used only by a single thread.
+//
+class DerivedValues final {
+public:
+    using Computation = InlineFunction<Value(DerivedValueReader&),
+                                       BLACKBOARD_EVENT_HANDLER_CAPACITY>;
+    using Observer = InlineFunction<void(std::string_view, const Value&),
+                                    BLACKBOARD_EVENT_HANDLER_CAPACITY>;
+    using EventID = Blackboard::EventID;
+
+    DerivedValues();
+    ~DerivedValues();
+
+    DerivedValues(const DerivedValues& from) = delete;
+    DerivedValues& operator=(const DerivedValues& from) = delete;
+
+    void SetInput(std::string_view name, const Value& value);
+    // Sets the input to `field` of every payload of the event that carries it. The blackboard must
+    // outlive the derived values, and be used by the same thread.
+    void BindInput(std::string_view name, Blackboard& blackboard, EventID eventId,
+                   const Value& field);
+    // Replaces any previous definition of the value, including that of an input.
+    void Define(std::string_view name, Computation&& computation);
+    void Observe(std::string_view name, Observer&& observer);
+
+    // Values that have been neither set nor defined are undefined.
+    Value Get(std::string_view name);
+    // Number of times computations have run.
+    std::size_t GetComputationCount() const;
+
+private:
+    friend class DerivedValueReader;
+
+    using Revision = std::uint64_t;
+
+    struct Node {
+        std::string name;
+        Value value;
+        Computation computation;
+        std::vector<std::size_t> dependencies;
+        // Revision in which the value last changed, and in which it was last found up to date.
+        Revision changedAt;
+        Revision verifiedAt;
+        // Longest path to an input, which orders the observed values.
+        std::size_t depth;
+        bool computing;
+    };
+
+    struct ObservedValue {
+        std::size_t node;
+        Observer observer;
+        Revision notifiedAt;
+    };
+
+    struct InputBinding {
+        Blackboard* blackboard;
+        Blackboard::Event eventId;
+        EventHandlerUniqueId eventHandlerId;
+    };
+
+    std::size_t GetNode(std::string_view name);
+    const Value& Update(std::size_t node);
+    bool DependenciesChanged(std::size_t node);
+    void Recompute(std::size_t node);
+    void NotifyObservers();
+
+    // A deque, so that nodes added while computing do not move the ones being updated.
+    std::deque<Node> nodes;
+    std::map<std::string, std::size_t, std::less<>> nodesByName;
+    Revision revision;
+    std::size_t computations;
+
+    std::vector<ObservedValue> observedValues;
+    // Observers that change inputs make the observed values be brought up to date once more.
+    bool notifyingObservers;
+    bool observersPending;
+
+    std::vector<InputBinding> inputBindings;
+};
+
+} // namespace blackboard
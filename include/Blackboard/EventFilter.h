@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace blackboard {
+
+// Counting Bloom filter over event hashes, which answers whether an event may have handlers
+// without locking or searching the events themselves. It never reports false negatives, so a
+// negative answer is final, while a positive one has to be confirmed.
+//
+class EventFilter {
+public:
+    EventFilter();
+    ~EventFilter();
+
+    EventFilter(const EventFilter& from) = delete;
+    EventFilter& operator=(const EventFilter& from) = delete;
+
+    void Insert(std::size_t hash) noexcept;
+    void Remove(std::size_t hash) noexcept;
+    bool MayContain(std::size_t hash) const noexcept;
+
+private:
+    static constexpr std::size_t numCounters = 2048;
+    static constexpr std::size_t numProbes = 2;
+
+    static std::size_t GetCounterIndex(std::size_t hash, std::size_t probe) noexcept;
+
+    std::array<std::atomic<std::uint16_t>, numCounters> counters;
+};
+
+} // namespace blackboard
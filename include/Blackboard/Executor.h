@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include "Blackboard/InlineFunction.h"
+
+#ifndef BLACKBOARD_EVENT_HANDLER_CAPACITY
+#define BLACKBOARD_EVENT_HANDLER_CAPACITY 64
+#endif // BLACKBOARD_EVENT_HANDLER_CAPACITY
+
+namespace blackboard {
+
+// Interface of anything that runs tasks asynchronously, on threads of its own choosing.
+//
+class Executor {
+public:
+    // Large enough to hold an async event handler along with its event ID and payload inline.
+    using Task = InlineFunction<void(), BLACKBOARD_EVENT_HANDLER_CAPACITY + 128>;
+
+    virtual ~Executor() = default;
+
+    virtual void Execute(Task&& task) = 0;
+};
+
+} // namespace blackboard
@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace blackboard {
+
+template <typename Signature, std::size_t Capacity = 64>
+class InlineFunction;
+
+// Type-erased callable wrapper, similar to std::function, which stores callables of up to
+// `Capacity` bytes inside the wrapper itself. Larger callables, as well as callables that may throw
+// while being moved, are stored on the heap instead.
+//
+template <typename Result, typename... Arguments, std::size_t Capacity>
+class InlineFunction<Result(Arguments...), Capacity> {
+    using Storage = std::aligned_storage_t<(Capacity < sizeof(void*) ? sizeof(void*) : Capacity),
+                                          alignof(std::max_align_t)>;
+
+    template <typename Callable>
+    using EnableIfCallable = std::enable_if_t<
+        !std::is_same_v<std::decay_t<Callable>, InlineFunction> &&
+        !std::is_same_v<std::decay_t<Callable>, std::nullptr_t> &&
+        std::is_invocable_r_v<Result, std::decay_t<Callable>&, Arguments...>>;
+
+public:
+    template <typename Callable>
+    static constexpr bool storesInline = sizeof(Callable) <= Capacity &&
+                                         alignof(Callable) <= alignof(Storage) &&
+                                         std::is_nothrow_move_constructible_v<Callable>;
+
+    static constexpr std::size_t capacity = Capacity;
+
+    InlineFunction() noexcept : operations(nullptr) {}
+
+    InlineFunction(std::nullptr_t) noexcept : operations(nullptr) {}
+
+    template <typename Callable, typename = EnableIfCallable<Callable>>
+    InlineFunction(Callable&& callable) : operations(nullptr) {
+        using StoredCallable = std::decay_t<Callable>;
+
+        if constexpr (std::is_pointer_v<std::remove_reference_t<Callable>> ||
+                      std::is_member_pointer_v<std::remove_reference_t<Callable>>) {
+            if (!callable) {
+                return;
+            }
+        }
+
+        if constexpr (storesInline<StoredCallable>) {
+            new (&storage) StoredCallable(std::forward<Callable>(callable));
+            operations = &inlineOperations<StoredCallable>;
+        } else {
+            new (&storage) StoredCallable*(new StoredCallable(std::forward<Callable>(callable)));
+            operations = &heapOperations<StoredCallable>;
+        }
+    }
+
+    InlineFunction(const InlineFunction& from) : operations(nullptr) {
+        if (from.operations) {
+            from.operations->copy(&storage, &from.storage);
+            operations = from.operations;
+        }
+    }
+
+    InlineFunction(InlineFunction&& from) noexcept : operations(nullptr) {
+        if (from.operations) {
+            from.operations->move(&storage, &from.storage);
+            operations = from.operations;
+            from.operations = nullptr;
+        }
+    }
+
+    ~InlineFunction() {
+        Clear();
+    }
+
+    InlineFunction& operator=(const InlineFunction& from) {
+        if (this != &from) {
+            InlineFunction copy(from);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    InlineFunction& operator=(InlineFunction&& from) noexcept {
+        if (this != &from) {
+            Clear();
+            if (from.operations) {
+                from.operations->move(&storage, &from.storage);
+                operations = from.operations;
+                from.operations = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    InlineFunction& operator=(std::nullptr_t) noexcept {
+        Clear();
+        return *this;
+    }
+
+    Result operator()(Arguments... arguments) const {
+        assert(operations && "Invoking empty InlineFunction!");
+        return operations->invoke(&storage, std::forward<Arguments>(arguments)...);
+    }
+
+    explicit operator bool() const noexcept {
+        return operations != nullptr;
+    }
+
+    // Binds a free function known at compile time, so that it is called directly instead of
+    // through a function pointer.
+    //
+    template <auto Function>
+    static InlineFunction Bind() noexcept {
+        return InlineFunction([](Arguments... arguments) -> Result {
+            return static_cast<Result>(std::invoke(Function,
+                                                   std::forward<Arguments>(arguments)...));
+        });
+    }
+
+    // Binds a member function known at compile time to `instance`, without requiring a wrapper
+    // lambda at the call site.
+    //
+    template <auto MemberFunction, typename Class>
+    static InlineFunction Bind(Class* instance) noexcept {
+        static_assert(std::is_member_function_pointer_v<decltype(MemberFunction)>);
+        assert(instance);
+        return InlineFunction([instance](Arguments... arguments) -> Result {
+            return static_cast<Result>(std::invoke(MemberFunction, instance,
+                                                   std::forward<Arguments>(arguments)...));
+        });
+    }
+
+private:
+    struct Operations {
+        Result (*invoke)(void* callable, Arguments... arguments);
+        void (*copy)(void* to, const void* from);
+        void (*move)(void* to, void* from) noexcept;
+        void (*destroy)(void* callable) noexcept;
+    };
+
+    template <typename Callable>
+    static Result Invoke(Callable& callable, Arguments... arguments) {
+        if constexpr (std::is_void_v<Result>) {
+            std::invoke(callable, std::forward<Arguments>(arguments)...);
+        } else {
+            return std::invoke(callable, std::forward<Arguments>(arguments)...);
+        }
+    }
+
+    template <typename Callable>
+    static constexpr Operations inlineOperations = {
+        [](void* callable, Arguments... arguments) -> Result {
+            return Invoke(*static_cast<Callable*>(callable),
+                          std::forward<Arguments>(arguments)...);
+        },
+        [](void* to, const void* from) {
+            new (to) Callable(*static_cast<const Callable*>(from));
+        },
+        [](void* to, void* from) noexcept {
+            new (to) Callable(std::move(*static_cast<Callable*>(from)));
+            static_cast<Callable*>(from)->~Callable();
+        },
+        [](void* callable) noexcept {
+            static_cast<Callable*>(callable)->~Callable();
+        }
+    };
+
+    template <typename Callable>
+    static constexpr Operations heapOperations = {
+        [](void* callable, Arguments... arguments) -> Result {
+            return Invoke(**static_cast<Callable**>(callable),
+                          std::forward<Arguments>(arguments)...);
+        },
+        [](void* to, const void* from) {
+            new (to) Callable*(new Callable(**static_cast<Callable* const*>(from)));
+        },
+        [](void* to, void* from) noexcept {
+            new (to) Callable*(*static_cast<Callable**>(from));
+        },
+        [](void* callable) noexcept {
+            delete *static_cast<Callable**>(callable);
+        }
+    };
+
+    void Clear() noexcept {
+        if (operations) {
+            operations->destroy(&storage);
+            operations = nullptr;
+        }
+    }
+
+    mutable Storage storage;
+    const Operations* operations;
+};
+
+} // namespace blackboard
@@ -0,0 +1,239 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include "Blackboard/Agenda.h"
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/InlineFunction.h"
+#include "Blackboard/Object.h"
+#include "Blackboard/Span.h"
+#include "Blackboard/ThreadPool.h"
+#include "Blackboard/Value.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace blackboard {
+
+using FactId = std::uint64_t;
+using KnowledgeSourceId = std::size_t;
+
+// Condition of a knowledge source, which matches facts of a type whose fields equal the given
+// values. Fields bound to the same variable, either within a pattern or across the patterns of a
+// knowledge source, are required to be equal.
+//
+class FactPattern {
+public:
+    explicit FactPattern(std::string_view factType);
+
+    FactPattern& Where(const Value& field, const Value& value);
+    FactPattern& Bind(const Value& field, std::string_view variable);
+
+private:
+    friend class KnowledgeBase;
+
+    std::string factType;
+    std::vector<std::pair<Value, Value>> tests;
+    std::vector<std::pair<Value, std::string>> bindings;
+};
+
+class KnowledgeBase;
+
+// Reads and writes of an activation of a knowledge source, which see the facts as they were when
+// the activation started, and are applied only once it commits. An activation commits only if
+// none of the facts it read or matched has changed in the meantime, otherwise it is run again.
+//
+class KnowledgeTransaction {
+public:
+    // Returns null for facts that do not exist. Writes of the transaction itself are not visible.
+    const Object* ReadFact(FactId factId);
+    void AssertFact(std::string_view factType, const Object& content);
+    void UpdateFact(FactId factId, const Object& content);
+    void RetractFact(FactId factId);
+
+private:
+    friend class KnowledgeBase;
+
+    enum class WriteKind : uint8_t {
+        Assert,
+        Update,
+        Retract
+    };
+
+    struct Write {
+        WriteKind kind;
+        FactId factId;
+        std::string factType;
+        Object content;
+    };
+
+    explicit KnowledgeTransaction(const KnowledgeBase& knowledgeBase);
+
+    const KnowledgeBase* knowledgeBase;
+    // Versions of the facts read, with those of the matched facts first.
+    std::vector<std::pair<FactId, std::uint64_t>> readSet;
+    std::vector<Write> writes;
+};
+
+// Facts of the board along with the knowledge sources that react to them. The conditions of the
+// knowledge sources are compiled into a Rete network, which shares the memories of identical
+// patterns and keeps the partial matches of every knowledge source, so that asserting, updating or
+// retracting a fact only joins it with the matches it may extend. Matches never contain the same
+// fact twice.
+//
+// Every new complete match places an activation of its knowledge source on the agenda, ranked by
+// the score the scoring function assigns to it, with higher scores running first and equal ones in
+// the order they were found. Activations whose facts are updated or retracted before they run are
+// withdrawn. The agenda is run after every change, unless the knowledge base is created with
+// RunAgendaAutomatically::No, in which case it is only run by RunAgenda().
+//
+// Knowledge sources whose actions access facts only through a KnowledgeTransaction may also be run
+// speculatively in parallel by RunAgendaInParallel(), in which case their actions may be invoked
+// concurrently and must not throw.
+//
+// Must be used only by a single thread.
+//
+class KnowledgeBase final {
+public:
+    struct Fact {
+        FactId id;
+        std::string type;
+        Object content;
+        // Starts from 1 and is incremented by every update.
+        std::uint64_t version;
+    };
+
+    // Facts matched by each of the conditions of a knowledge source, in the same order.
+    using FactSpan = Span<const Fact* const>;
+    using KnowledgeSourceAction = InlineFunction<void(FactSpan),
+                                                 BLACKBOARD_EVENT_HANDLER_CAPACITY>;
+    using TransactionalKnowledgeSourceAction =
+            InlineFunction<void(FactSpan, KnowledgeTransaction&),
+                           BLACKBOARD_EVENT_HANDLER_CAPACITY>;
+    // Returns the benefit of an activation minus its cost.
+    using ActivationScoring = InlineFunction<double(KnowledgeSourceId, FactSpan),
+                                             BLACKBOARD_EVENT_HANDLER_CAPACITY>;
+    using Duration = Blackboard::Duration;
+
+    enum class RunAgendaAutomatically : bool {
+        No,
+        Yes
+    };
+
+    explicit KnowledgeBase(RunAgendaAutomatically runAgendaAutomatically =
+                                   RunAgendaAutomatically::Yes);
+    ~KnowledgeBase();
+
+    KnowledgeBase(const KnowledgeBase& from) = delete;
+    KnowledgeBase& operator=(const KnowledgeBase& from) = delete;
+
+    KnowledgeSourceId AddKnowledgeSource(const std::vector<FactPattern>& conditions,
+                                         KnowledgeSourceAction&& action);
+    KnowledgeSourceId AddKnowledgeSource(const std::vector<FactPattern>& conditions,
+                                         TransactionalKnowledgeSourceAction&& action);
+
+    FactId AssertFact(std::string_view factType, const Object& content);
+    void UpdateFact(FactId factId, const Object& content);
+    void RetractFact(FactId factId);
+    const Fact* GetFact(FactId factId) const;
+    std::size_t GetFactCount() const;
+
+    // Applies to the activations found from now on.
+    void SetActivationScoring(ActivationScoring&& activationScoring);
+    // Runs activations in order of score until the agenda is empty or `maxDuration` has passed,
+    // and returns how many ran. Does nothing when called by an action.
+    std::size_t RunAgenda(Duration maxDuration = Duration::max());
+    // Same as RunAgenda(), except that consecutive activations of transactional knowledge sources
+    // run in parallel on `threadPool`, and are then committed one by one in agenda order.
+    std::size_t RunAgendaInParallel(ThreadPool& threadPool, Duration maxDuration = Duration::max());
+    std::size_t GetPendingActivationCount() const;
+    std::size_t GetRetriedActivationCount() const;
+
+private:
+    using Token = std::vector<const Fact*>;
+
+    struct AlphaMemory {
+        std::string factType;
+        std::vector<std::pair<Value, Value>> tests;
+        std::vector<const Fact*> facts;
+        // Knowledge sources and the indices of their conditions that use this memory.
+        std::vector<std::pair<KnowledgeSourceId, std::size_t>> successors;
+    };
+
+    struct JoinTest {
+        std::size_t factIndex;
+        Value field;
+        Value otherField;
+    };
+
+    struct KnowledgeSource {
+        std::vector<AlphaMemory*> alphaMemories;
+        std::vector<std::vector<JoinTest>> joinTests;
+        // Matches of the first `i + 1` conditions.
+        std::vector<std::vector<Token>> betaMemories;
+        KnowledgeSourceAction action;
+        TransactionalKnowledgeSourceAction transactionalAction;
+    };
+
+    struct SpeculativeActivation {
+        KnowledgeSourceId knowledgeSourceId;
+        Token token;
+        KnowledgeTransaction transaction;
+    };
+
+    struct Activation {
+        KnowledgeSourceId knowledgeSourceId;
+        Token token;
+    };
+
+    KnowledgeSourceId AddKnowledgeSourceInternal(const std::vector<FactPattern>& conditions,
+                                                 KnowledgeSource&& knowledgeSource);
+    AlphaMemory* GetAlphaMemory(const FactPattern& condition);
+    static bool MatchesAlphaMemory(const AlphaMemory& alphaMemory, const Fact& fact);
+    static bool MatchesJoinTests(const std::vector<JoinTest>& joinTests, const Token& token,
+                                 const Fact& fact);
+
+    void AddToNetwork(const Fact& fact);
+    void RemoveFromNetwork(const Fact& fact);
+    void ActivateRight(KnowledgeSourceId knowledgeSourceId, std::size_t condition,
+                       const Fact& fact);
+    void ExtendMatch(KnowledgeSourceId knowledgeSourceId, std::size_t condition, Token&& token);
+    void AddActivation(KnowledgeSourceId knowledgeSourceId, const Token& token);
+    void ReleaseActivation(Agenda::EntryId activationId);
+    void OnFactsChanged();
+
+    Token PopActivation(KnowledgeSourceId* knowledgeSourceId);
+    bool IsTransactional(KnowledgeSourceId knowledgeSourceId) const;
+    KnowledgeTransaction BeginTransaction(const Token& token) const;
+    bool CommitTransaction(const KnowledgeTransaction& transaction);
+    void RunActivation(KnowledgeSourceId knowledgeSourceId, const Token& token);
+
+    std::map<FactId, Fact> facts;
+    FactId nextFactId;
+
+    std::vector<std::unique_ptr<AlphaMemory>> alphaMemories;
+    std::unordered_map<std::string, std::vector<AlphaMemory*>> alphaMemoriesByType;
+    // A deque, so that knowledge sources added by actions do not move the one being activated.
+    std::deque<KnowledgeSource> knowledgeSources;
+
+    // Activations are indexed by their agenda entry, with the slots of finished ones reused.
+    std::vector<Activation> activations;
+    std::vector<Agenda::EntryId> freeActivationIds;
+    std::unordered_map<const Fact*, std::vector<Agenda::EntryId>> activationsByFact;
+    Agenda agenda;
+    ActivationScoring activationScoring;
+    bool runAgendaAutomatically;
+    bool runningAgenda;
+    std::size_t retriedActivations;
+};
+
+} // namespace blackboard
@@ -6,11 +6,18 @@
 #include <memory>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 namespace blackboard {
 
 class Value;
 struct ValueHash;
+struct ObjectChange;
+
+// Keys leading to a value through nested objects, e.g. {"Pose", "X"}.
+using KeyPath = std::vector<Value>;
+// Changes that turn an object into another, in no particular order.
+using ObjectDelta = std::vector<ObjectChange>;
 
 class Object {
 public:
@@ -28,10 +35,25 @@ public:
     std::optional<Value> GetValue(const Value& key) const;
     Object& AddValue(const Value& key, const Value& value);
     Object& RemoveValue(const Value& key);
+    // Keeps the buckets of the map, so that refilling the object reuses them.
+    Object& Clear();
+
+    std::optional<Value> GetValueAt(const KeyPath& keyPath) const;
+
+    // Returns only the values that differ from `other`, descending into nested objects, so that
+    // patching this object with the result makes it equal to `other`. The second overload
+    // compares only the values at `keyPaths`.
+    ObjectDelta Diff(const Object& other) const;
+    ObjectDelta Diff(const Object& other, const std::vector<KeyPath>& keyPaths) const;
+    // Creates the nested objects of the key paths that do not exist.
+    Object& Patch(const ObjectDelta& delta);
 
 private:
     using Values = std::unordered_map<const Value, Value, ValueHash>;
 
+    const Value* FindValueAt(const KeyPath& keyPath) const;
+    void DiffInto(const Object& other, KeyPath* keyPath, ObjectDelta* delta) const;
+
     std::unique_ptr<Values> values;
 };
 
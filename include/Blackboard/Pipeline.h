@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/Object.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace blackboard {
+
+// Event of a pipeline, along with the number of stages it skips.
+struct PipelineInput {
+    Blackboard::Event eventId;
+    std::size_t entry;
+};
+
+// Stages of a pipeline pass their output directly to the next stage, so that the whole chain is
+// fused into a single handler. Events merged into a pipeline enter it after the stages that
+// precede the merge, which they skip.
+
+struct PipelineSource {
+    static constexpr std::size_t depth = 0;
+
+    template <typename Sink>
+    bool operator()(std::size_t, Blackboard::EventID eventId, const Object& eventContent,
+                    Sink&& sink) {
+        return sink(eventId, eventContent);
+    }
+};
+
+template <typename Previous, typename Predicate>
+struct PipelineFilter {
+    static constexpr std::size_t depth = Previous::depth + 1;
+
+    template <typename Sink>
+    bool operator()(std::size_t entry, Blackboard::EventID eventId, const Object& eventContent,
+                    Sink&& sink) {
+        return previous(entry, eventId, eventContent,
+                        [this, entry, &sink](Blackboard::EventID eventId,
+                                             const Object& eventContent) {
+            if (entry >= depth || std::invoke(predicate, eventContent)) {
+                return sink(eventId, eventContent);
+            }
+            return true;
+        });
+    }
+
+    Previous previous;
+    Predicate predicate;
+};
+
+// Mappers write into an object owned by the stage, which is cleared before every event, so that
+// its allocation is reused without fields of earlier events carrying over.
+template <typename Previous, typename Mapper>
+struct PipelineMap {
+    static constexpr std::size_t depth = Previous::depth + 1;
+
+    template <typename Sink>
+    bool operator()(std::size_t entry, Blackboard::EventID eventId, const Object& eventContent,
+                    Sink&& sink) {
+        return previous(entry, eventId, eventContent,
+                        [this, entry, &sink](Blackboard::EventID eventId,
+                                             const Object& eventContent) {
+            if (entry >= depth) {
+                return sink(eventId, eventContent);
+            }
+            mappedEventContent.Clear();
+            std::invoke(mapper, eventContent, mappedEventContent);
+            return sink(eventId, mappedEventContent);
+        });
+    }
+
+    Previous previous;
+    Mapper mapper;
+    Object mappedEventContent;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+// Declarative chain of filter, map and merge operators over event payloads, e.g.:
+//
+//     Pipeline("A").Filter(isValid).Map(toB).Merge("C").PostTo(blackboard, "D");
+//
+// Each event of the pipeline is subscribed to with a handler that runs the fused chain, instead
+// of a handler per stage that posts an intermediate event.
+//
+template <typename Stage = PipelineSource>
+class Pipeline {
+    template <typename OtherStage>
+    friend class Pipeline;
+
+public:
+    using Event = Blackboard::Event;
+    using EventID = Blackboard::EventID;
+    using CallEventHandlerOnce = Blackboard::CallEventHandlerOnce;
+
+    explicit Pipeline(EventID eventId) : inputs{{Event(eventId), 0}}, stage() {}
+
+    template <typename Predicate>
+    Pipeline<PipelineFilter<Stage, std::decay_t<Predicate>>> Filter(Predicate&& predicate) const {
+        return {inputs, {stage, std::forward<Predicate>(predicate)}};
+    }
+
+    template <typename Mapper>
+    Pipeline<PipelineMap<Stage, std::decay_t<Mapper>>> Map(Mapper&& mapper) const {
+        return {inputs, {stage, std::forward<Mapper>(mapper), Object()}};
+    }
+
+    Pipeline Merge(EventID eventId) const {
+        auto pipeline = *this;
+        pipeline.inputs.push_back({Event(eventId), Stage::depth});
+        return pipeline;
+    }
+
+    // Returns the IDs of the handlers of the events of the pipeline, in the order they were added.
+    template <typename Callable>
+    std::vector<EventHandlerUniqueId> ForEach(Blackboard& blackboard, Callable&& callable,
+                                              CallEventHandlerOnce callOnce =
+                                                      CallEventHandlerOnce::No) const {
+        std::vector<EventHandlerUniqueId> eventHandlerIds;
+        eventHandlerIds.reserve(inputs.size());
+        for (const auto& input : inputs) {
+            // Shared, since handlers are copied on every invocation, while each event gets its own
+            // copy of the stages, because different events may be posted concurrently.
+            auto fusedHandler = std::make_shared<FusedHandler<std::decay_t<Callable>>>(
+                    FusedHandler<std::decay_t<Callable>>{stage, callable});
+            eventHandlerIds.push_back(blackboard.AddEventHandler(input.eventId,
+                    [fusedHandler = std::move(fusedHandler), entry = input.entry](
+                            EventID eventId, const Object& eventContent) {
+                return fusedHandler->stage(entry, eventId, eventContent, fusedHandler->callable);
+            }, callOnce));
+        }
+        return eventHandlerIds;
+    }
+
+    std::vector<EventHandlerUniqueId> PostTo(Blackboard& blackboard, EventID resultEventId,
+                                             CallEventHandlerOnce callOnce =
+                                                     CallEventHandlerOnce::No) const {
+        auto postEvent = [blackboard = &blackboard, resultEventId = Event(resultEventId)](
+                EventID, const Object& eventContent) {
+            blackboard->PostEvent(resultEventId, eventContent);
+            return true;
+        };
+        return ForEach(blackboard, std::move(postEvent), callOnce);
+    }
+
+private:
+    template <typename Callable>
+    struct FusedHandler {
+        Stage stage;
+        Callable callable;
+    };
+
+    Pipeline(const std::vector<PipelineInput>& inputs, Stage&& stage)
+        : inputs(inputs), stage(std::move(stage)) {}
+
+    std::vector<PipelineInput> inputs;
+    Stage stage;
+};
+
+} // namespace blackboard
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace blackboard {
+
+// Bounded FIFO buffer, whose elements are allocated once and reused, so that pushing into a full
+// buffer overwrites its oldest element in place.
+//
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(std::size_t capacity) : elements(capacity), first(0), size(0) {
+        assert(capacity > 0);
+    }
+
+    // Returns the slot that follows the newest element, which the caller is expected to assign to.
+    // The returned slot still holds its previous value, which is overwritten only once assigned.
+    T& Push() {
+        const auto capacity = elements.size();
+        if (size == capacity) {
+            auto& slot = elements[first];
+            first = (first + 1) % capacity;
+            return slot;
+        }
+        return elements[(first + size++) % capacity];
+    }
+
+    void Pop() {
+        assert(size > 0);
+        first = (first + 1) % elements.size();
+        --size;
+    }
+
+    T& Front() {
+        assert(size > 0);
+        return elements[first];
+    }
+
+    T& Back() {
+        assert(size > 0);
+        return elements[(first + size - 1) % elements.size()];
+    }
+
+    T& operator[](std::size_t index) {
+        assert(index < size);
+        return elements[(first + index) % elements.size()];
+    }
+
+    const T& operator[](std::size_t index) const {
+        assert(index < size);
+        return elements[(first + index) % elements.size()];
+    }
+
+    void Clear() {
+        first = 0;
+        size = 0;
+    }
+
+    bool IsEmpty() const {
+        return size == 0;
+    }
+
+    bool IsFull() const {
+        return size == elements.size();
+    }
+
+    std::size_t GetSize() const {
+        return size;
+    }
+
+    std::size_t GetCapacity() const {
+        return elements.size();
+    }
+
+private:
+    std::vector<T> elements;
+    std::size_t first;
+    std::size_t size;
+};
+
+} // namespace blackboard
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/Object.h"
+#include "Blackboard/Value.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace blackboard {
+
+// Sequence of events that follow each other, e.g.:
+//
+//     SequencePattern().Then("A").Without("C").Then("B").Within(50ms).CorrelatedBy(Value{"Key"s})
+//
+// which matches an A followed by a B carrying the same "Key" within 50 ms, without any C carrying
+// that key in between. Events not mentioned by the pattern may occur anywhere.
+//
+class SequencePattern {
+public:
+    using Event = Blackboard::Event;
+    using EventID = Blackboard::EventID;
+    using Duration = Blackboard::Duration;
+
+    SequencePattern();
+
+    SequencePattern& Then(EventID eventId);
+    // Applies between the previous step and the next one.
+    SequencePattern& Without(EventID eventId);
+    // Measured from the first step to the last one.
+    SequencePattern& Within(Duration window);
+    // Only events whose payloads carry equal values of `keyField` take part in the same match.
+    SequencePattern& CorrelatedBy(const Value& keyField);
+
+private:
+    friend class SequenceDetector;
+
+    struct Step {
+        Event eventId;
+        std::vector<Event> negatedEventIds;
+    };
+
+    std::vector<Step> steps;
+    std::vector<Event> negatedEventIds;
+    Duration window;
+    std::optional<Value> keyField;
+};
+
+// Detects sequence patterns in the events of a blackboard, and posts a match event for each match,
+// carrying the payloads of its steps as "Events", indexed from 0, along with its "Key", if
+// correlated. Patterns are compiled into a single NFA, whose states are shared by all patterns
+// with the same window, key and prefix, as are their partial matches. Partial matches are kept per
+// key, and every partial match advances to each next state at most once, at the first event that
+// takes it there, while it is evicted either when its window expires or once it can no longer
+// advance to any state. Each state holds at most `maxPartialMatchesPerState` partial matches, so
+// that patterns without a window cannot accumulate them indefinitely, and the oldest one is
+// evicted to make room for a new one.
+//
+// Events are timestamped when dispatched. Expired partial matches are evicted by the events of the
+// patterns and by Advance(). Must be created and destroyed by the owner of the blackboard, and
+// outlived by it.
+//
+// Must be used only by a single thread, which must also be the only one posting the events of its
+// patterns, since their handlers update the partial matches without locking.
+//
+class SequenceDetector final {
+public:
+    using Event = Blackboard::Event;
+    using EventID = Blackboard::EventID;
+    using Duration = Blackboard::Duration;
+    using Deadline = Blackboard::Deadline;
+
+    static constexpr std::size_t defaultMaxPartialMatchesPerState = 1 << 12;
+
+    explicit SequenceDetector(Blackboard& blackboard,
+                              std::size_t maxPartialMatchesPerState =
+                                      defaultMaxPartialMatchesPerState);
+    ~SequenceDetector();
+
+    SequenceDetector(const SequenceDetector& from) = delete;
+    SequenceDetector& operator=(const SequenceDetector& from) = delete;
+
+    void AddPattern(const SequencePattern& pattern, EventID matchEventId);
+    // Evicts the partial matches whose windows have expired by `now`.
+    void Advance(Deadline now);
+
+    std::size_t GetStateCount() const;
+    std::size_t GetPartialMatchCount() const;
+    std::size_t GetEvictedPartialMatchCount() const;
+
+private:
+    static constexpr std::size_t maxTransitions = 64;
+
+    // Payloads of the steps matched so far, newest first, shared between partial matches, as is
+    // each payload between the partial matches it advances.
+    struct MatchedStep {
+        std::shared_ptr<const Object> eventContent;
+        std::shared_ptr<const MatchedStep> previous;
+    };
+
+    struct PartialMatch {
+        std::size_t state;
+        Value key;
+        Deadline start;
+        std::shared_ptr<const MatchedStep> matchedSteps;
+        // Transitions of the state the partial match has either taken or been blocked from.
+        std::uint64_t closedTransitions;
+        std::size_t position;
+        // Neighbours in the order the partial matches of the state have entered it.
+        std::size_t older;
+        std::size_t newer;
+        std::uint32_t generation;
+    };
+
+    struct State {
+        std::size_t root;
+        std::size_t parent;
+        std::size_t depth;
+        Event eventId;
+        std::vector<Event> negatedEventIds;
+        std::vector<std::size_t> transitions;
+        std::vector<Event> matchEventIds;
+        std::unordered_map<Value, std::vector<std::size_t>, ValueHash> partialMatchesByKey;
+        std::size_t oldestPartialMatch;
+        std::size_t newestPartialMatch;
+        std::size_t partialMatchCount;
+    };
+
+    struct Root {
+        Duration window;
+        std::optional<Value> keyField;
+        std::size_t state;
+    };
+
+    // Transitions taken or blocked by an event, as pairs of a state and a transition index.
+    struct EventTransitions {
+        std::vector<std::size_t> startingStates;
+        std::vector<std::pair<std::size_t, std::size_t>> advancingTransitions;
+        std::vector<std::pair<std::size_t, std::size_t>> negatingTransitions;
+        EventHandlerUniqueId eventHandlerId;
+    };
+
+    struct Expiry {
+        Deadline expiry;
+        std::size_t partialMatch;
+        std::uint32_t generation;
+
+        bool operator>(const Expiry& other) const {
+            return expiry > other.expiry;
+        }
+    };
+
+    // Partial or complete match entering a state.
+    struct Match {
+        std::size_t state;
+        Value key;
+        Deadline start;
+        std::shared_ptr<const MatchedStep> matchedSteps;
+    };
+
+    std::size_t GetRoot(const SequencePattern& pattern);
+    std::size_t GetState(std::size_t parent, const SequencePattern::Step& step);
+    EventTransitions& GetEventTransitions(EventID eventId);
+
+    bool OnEvent(EventID eventId, const Object& eventContent);
+    std::optional<Value> GetKey(std::size_t state, const Object& eventContent) const;
+    void CloseTransition(std::size_t partialMatch, std::size_t transition);
+    void Enter(Match&& match, std::vector<Match>* matches);
+    void RemovePartialMatch(std::size_t partialMatch);
+    void PostMatch(const Match& match);
+
+    Blackboard& blackboard;
+    const std::size_t maxPartialMatchesPerState;
+    std::vector<Root> roots;
+    std::vector<State> states;
+    std::map<Event, EventTransitions, std::less<>> eventTransitions;
+
+    // Partial matches are indexed by their slot, with the slots of removed ones reused.
+    std::vector<PartialMatch> partialMatches;
+    std::vector<std::size_t> freePartialMatches;
+    std::priority_queue<Expiry, std::vector<Expiry>, std::greater<>> expiries;
+    std::size_t partialMatchCount;
+    std::size_t evictedPartialMatches;
+};
+
+} // namespace blackboard
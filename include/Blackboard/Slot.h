@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/Channel.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace blackboard {
+
+// Latest value of a high-rate scalar, e.g. a sensor reading or a counter, which is written by a
+// single thread and read by any number of threads through a seqlock, without locking or
+// allocating. Readers retry whenever they overlap with a store, so they never see a torn value,
+// while the writer never waits for them.
+//
+// If created with a blackboard, changes are not posted by Store(), but by PostChange(), which the
+// writer calls at its own pace, so that any number of stores in between results in a single event
+// carrying the latest value, posted only if the channel has handlers.
+//
+template <typename T>
+class Slot final {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>,
+                  "Slots hold only trivially copyable values");
+
+public:
+    explicit Slot(const T& value = T()) : sequence(0), words(), blackboard(nullptr),
+                                          changeChannel(0), postedSequence(0) {
+        StoreWords(value);
+    }
+
+    Slot(Blackboard& blackboard, Channel<T> changeChannel, const T& value = T())
+        : Slot(value) {
+        this->blackboard = &blackboard;
+        this->changeChannel = changeChannel;
+    }
+
+    Slot(const Slot& from) = delete;
+    Slot& operator=(const Slot& from) = delete;
+
+    // Must be called only by the writer.
+    void Store(const T& value) {
+        const auto currentSequence = sequence.load(std::memory_order_relaxed);
+        sequence.store(currentSequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        StoreWords(value);
+        sequence.store(currentSequence + 2, std::memory_order_release);
+    }
+
+    T Load() const {
+        Word buffer[numWords];
+        while (true) {
+            const auto currentSequence = sequence.load(std::memory_order_acquire);
+            if (currentSequence & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (std::size_t i = 0; i < numWords; ++i) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == currentSequence) {
+                break;
+            }
+        }
+
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    // Number of stores so far.
+    std::uint64_t GetVersion() const {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+
+    // Posts the latest value to the change channel, if it has been stored since the last call, and
+    // returns whether it had. Must be called only by the writer.
+    bool PostChange() {
+        const auto currentSequence = sequence.load(std::memory_order_relaxed);
+        if (!blackboard || currentSequence == postedSequence) {
+            return false;
+        }
+        postedSequence = currentSequence;
+        blackboard->PostEvent(changeChannel, [this] { return Load(); });
+        return true;
+    }
+
+private:
+    using Word = std::uint64_t;
+
+    static constexpr std::size_t numWords = (sizeof(T) + sizeof(Word) - 1) / sizeof(Word);
+
+    void StoreWords(const T& value) {
+        Word buffer[numWords] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        for (std::size_t i = 0; i < numWords; ++i) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+    }
+
+    // Odd while a store is in progress. Slots are kept on separate cache lines, so that readers of
+    // one slot do not contend with the writer of another.
+    alignas(64) std::atomic<std::uint64_t> sequence;
+    // Values are copied word by word through atomics, since readers may overlap with a store.
+    std::atomic<Word> words[numWords];
+
+    // Used only by the writer.
+    alignas(64) Blackboard* blackboard;
+    Channel<T> changeChannel;
+    std::uint64_t postedSequence;
+};
+
+} // namespace blackboard
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+namespace blackboard {
+
+// Non-owning view of a contiguous sequence of elements, similar to the std::span of C++20.
+//
+template <typename T>
+class Span {
+public:
+    constexpr Span() noexcept : elements(nullptr), size(0) {}
+
+    constexpr Span(T* elements, std::size_t size) noexcept : elements(elements), size(size) {}
+
+    constexpr T* begin() const noexcept {
+        return elements;
+    }
+
+    constexpr T* end() const noexcept {
+        return elements + size;
+    }
+
+    constexpr T& operator[](std::size_t index) const {
+        assert(index < size);
+        return elements[index];
+    }
+
+    constexpr T* GetData() const noexcept {
+        return elements;
+    }
+
+    constexpr std::size_t GetSize() const noexcept {
+        return size;
+    }
+
+    constexpr bool IsEmpty() const noexcept {
+        return size == 0;
+    }
+
+private:
+    T* elements;
+    std::size_t size;
+};
+
+} // namespace blackboard
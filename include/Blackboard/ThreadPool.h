@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include "Blackboard/Executor.h"
+#include "Blackboard/InlineFunction.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace blackboard {
+
+// Fixed-size pool of worker threads, each of which has its own task queue. Tasks executed by a
+// worker are queued to that worker and run in LIFO order, while idle workers steal the oldest tasks
+// of the others, so that bursts of tasks spread across the pool without a single contended queue.
+//
+class ThreadPool : public Executor {
+public:
+    using IndexedTask = InlineFunction<void(std::size_t), 64>;
+
+    explicit ThreadPool(std::size_t threadCount);
+    ~ThreadPool() override;
+
+    ThreadPool(const ThreadPool& from) = delete;
+    ThreadPool& operator=(const ThreadPool& from) = delete;
+
+    void Execute(Task&& task) override;
+
+    // Invokes `task` once for every index in [0, count), sharing the indices between the workers
+    // and the calling thread, and returns once every invocation has returned. The task must not
+    // throw.
+    void ParallelFor(std::size_t count, const IndexedTask& task);
+
+    std::size_t GetThreadCount() const;
+
+    // One less than the number of hardware threads, since the calling thread takes part as well.
+    static std::size_t GetDefaultThreadCount();
+
+private:
+    struct Worker {
+        std::deque<Task> tasks;
+        std::mutex tasksMutex;
+    };
+
+    struct ParallelForState;
+
+    static void RunParallelForIndices(ParallelForState& state);
+
+    void RunWorker(std::size_t workerIndex);
+    bool TryToPopTask(std::size_t workerIndex, Task* task);
+    bool TryToStealTask(std::size_t workerIndex, Task* task);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<std::size_t> nextWorkerIndex;
+
+    std::atomic<std::size_t> queuedTasks;
+    std::mutex idleMutex;
+    std::condition_variable idleCondition;
+    bool stopping;
+};
+
+} // namespace blackboard
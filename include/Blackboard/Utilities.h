@@ -4,6 +4,15 @@
 #pragma once
 
 #include <variant>
+#include <cstdlib>
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define BLACKBOARD_EXCEPTIONS 1
+#define BLACKBOARD_THROW(exception) throw exception
+#else
+#define BLACKBOARD_EXCEPTIONS 0
+#define BLACKBOARD_THROW(exception) std::abort()
+#endif
 
 namespace blackboard {
 
@@ -14,7 +14,9 @@
 namespace blackboard {
 
 class Value {
+    friend class Object;
     friend struct ValueHash;
+    friend struct ValueLess;
 
 public:
     Value();
@@ -49,6 +51,13 @@ public:
     Object& ToObject() const;
 
     std::string GetType() const;
+    // Check the type without building its name, unlike GetType().
+    constexpr bool IsUndefined() const noexcept;
+    constexpr bool IsNumber() const noexcept;
+    constexpr bool IsString() const noexcept;
+    constexpr bool IsBoolean() const noexcept;
+    constexpr bool IsReference() const noexcept;
+    constexpr bool IsObject() const noexcept;
 
 private:
     using UndefinedType = std::monostate;
@@ -67,13 +76,6 @@ private:
     template <typename T>
     constexpr bool HasType() const noexcept;
 
-    constexpr bool IsUndefined() const noexcept;
-    constexpr bool IsNumber() const noexcept;
-    constexpr bool IsString() const noexcept;
-    constexpr bool IsBoolean() const noexcept;
-    constexpr bool IsReference() const noexcept;
-    constexpr bool IsObject() const noexcept;
-
     template <typename T>
     constexpr T Get() const noexcept;
 
@@ -93,8 +95,76 @@ private:
     ValueHolder value;
 };
 
+template <typename T>
+constexpr bool Value::HasType() const noexcept {
+    return std::holds_alternative<T>(value);
+}
+
+template <typename T>
+constexpr T Value::Get() const noexcept {
+    return std::get<T>(value);
+}
+
+constexpr bool Value::IsUndefined() const noexcept {
+    return HasType<Value::UndefinedType>();
+}
+
+constexpr bool Value::IsNumber() const noexcept {
+    return HasType<Value::NumberType>();
+}
+
+constexpr bool Value::IsString() const noexcept {
+    return HasType<Value::StringType>();
+}
+
+constexpr bool Value::IsBoolean() const noexcept {
+    return HasType<Value::BooleanType>();
+}
+
+constexpr bool Value::IsReference() const noexcept {
+    return HasType<Value::ReferenceType>();
+}
+
+constexpr bool Value::IsObject() const noexcept {
+    return HasType<Value::ObjectType>();
+}
+
+constexpr Value::NumberType Value::GetNumber() const noexcept {
+    return Get<Value::NumberType>();
+}
+
+constexpr Value::StringType Value::GetString() const noexcept {
+    return Get<Value::StringType>();
+}
+
+constexpr Value::BooleanType Value::GetBoolean() const noexcept {
+    return Get<Value::BooleanType>();
+}
+
+constexpr Value::ReferenceType Value::GetReference() const noexcept {
+    return Get<Value::ReferenceType>();
+}
+
+constexpr Value::ObjectType Value::GetObject() const noexcept {
+    return Get<Value::ObjectType>();
+}
+
+//--------------------------------------------------------------------------------------------------
+
 struct ValueHash {
     std::size_t operator()(const Value& value) const;
 };
 
+// Orders numbers before strings, numbers numerically and strings lexicographically. Defined only
+// for numbers other than NaN and strings.
+struct ValueLess {
+    bool operator()(const Value& lhs, const Value& rhs) const;
+};
+
+// Sets the value at a key path, or removes it if `value` is empty.
+struct ObjectChange {
+    KeyPath keyPath;
+    std::optional<Value> value;
+};
+
 } // namespace blackboard
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#pragma once
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/Object.h"
+#include "Blackboard/RingBuffer.h"
+#include "Blackboard/Value.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace blackboard {
+
+// Aggregates a number field of the payloads of an event over time windows, and posts the count,
+// sum, minimum, maximum, mean and requested percentiles of each window as a result event. Windows
+// consist of panes as long as the slide, whose aggregates are combined through a pair of stacks,
+// so that sliding a window costs O(1) amortised regardless of its number of panes. Tumbling
+// windows are sliding windows of a single pane.
+//
+// A window is closed by the first event to arrive after it, or by Advance(), while windows
+// without any samples are not posted. Must be created and destroyed by the owner of the
+// blackboard, and outlived by it.
+//
+class WindowAggregator final {
+public:
+    using Event = Blackboard::Event;
+    using EventID = Blackboard::EventID;
+    using Duration = Blackboard::Duration;
+    using Deadline = Blackboard::Deadline;
+
+    WindowAggregator(Blackboard& blackboard, EventID eventId, const Value& field,
+                     EventID resultEventId, Duration windowLength,
+                     const std::vector<double>& percentiles = {});
+    WindowAggregator(Blackboard& blackboard, EventID eventId, const Value& field,
+                     EventID resultEventId, Duration windowLength, Duration slide,
+                     const std::vector<double>& percentiles = {});
+    ~WindowAggregator();
+
+    WindowAggregator(const WindowAggregator& from) = delete;
+    WindowAggregator& operator=(const WindowAggregator& from) = delete;
+
+    // Closes the panes that end up to `now`, posting a result for each non-empty window.
+    void Advance(Deadline now);
+
+private:
+    struct Aggregate {
+        void Add(double sample);
+        static Aggregate Combine(const Aggregate& first, const Aggregate& second);
+
+        std::size_t count = 0;
+        double sum = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+    };
+
+    bool OnEvent(EventID eventId, const Object& eventContent);
+    void ClosePane();
+    void EvictPane();
+    void PostResult(const Aggregate& window);
+
+    Blackboard& blackboard;
+    Event eventId;
+    Value field;
+    Event resultEventId;
+    Duration slide;
+    std::size_t numPanes;
+    Deadline paneEnd;
+    EventHandlerUniqueId eventHandlerId;
+
+    Aggregate currentPane;
+    std::vector<Aggregate> frontPanes;
+    std::vector<Aggregate> backPanes;
+    Aggregate backPanesAggregate;
+
+    // Samples are kept only when percentiles are requested, with the ones of evicted panes being
+    // erased lazily, once they make up half of them.
+    std::vector<double> percentiles;
+    std::vector<double> samples;
+    std::size_t firstSample;
+    RingBuffer<std::size_t> paneSampleCounts;
+    std::vector<double> windowSamples;
+
+    Object result;
+    std::vector<Value> resultKeys;
+};
+
+} // namespace blackboard
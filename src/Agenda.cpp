@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/Agenda.h"
+
+#include <cassert>
+#include <limits>
+#include <utility>
+
+namespace blackboard {
+
+static constexpr std::size_t noHeapIndex = std::numeric_limits<std::size_t>::max();
+
+Agenda::Agenda() : heap(), heapIndices(), nextSequence(0) {}
+
+Agenda::~Agenda() = default;
+
+//--------------------------------------------------------------------------------------------------
+
+bool Agenda::IsBefore(const Entry& first, const Entry& second) {
+    if (first.score != second.score) {
+        return first.score > second.score;
+    }
+    return first.sequence < second.sequence;
+}
+
+void Agenda::Place(std::size_t heapIndex, Entry&& entry) {
+    heapIndices[entry.entryId] = heapIndex;
+    heap[heapIndex] = std::move(entry);
+}
+
+void Agenda::SiftUp(std::size_t heapIndex) {
+    auto entry = std::move(heap[heapIndex]);
+    while (heapIndex > 0) {
+        const auto parentIndex = (heapIndex - 1) / 2;
+        if (!IsBefore(entry, heap[parentIndex])) {
+            break;
+        }
+        Place(heapIndex, std::move(heap[parentIndex]));
+        heapIndex = parentIndex;
+    }
+    Place(heapIndex, std::move(entry));
+}
+
+void Agenda::SiftDown(std::size_t heapIndex) {
+    auto entry = std::move(heap[heapIndex]);
+    while (true) {
+        auto childIndex = 2 * heapIndex + 1;
+        if (childIndex >= heap.size()) {
+            break;
+        }
+        if (childIndex + 1 < heap.size() && IsBefore(heap[childIndex + 1], heap[childIndex])) {
+            ++childIndex;
+        }
+        if (!IsBefore(heap[childIndex], entry)) {
+            break;
+        }
+        Place(heapIndex, std::move(heap[childIndex]));
+        heapIndex = childIndex;
+    }
+    Place(heapIndex, std::move(entry));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Agenda::Push(EntryId entryId, double score) {
+    assert(!Contains(entryId));
+    if (entryId >= heapIndices.size()) {
+        heapIndices.resize(entryId + 1, noHeapIndex);
+    }
+    heap.push_back({entryId, score, nextSequence++});
+    heapIndices[entryId] = heap.size() - 1;
+    SiftUp(heap.size() - 1);
+}
+
+void Agenda::Update(EntryId entryId, double score) {
+    assert(Contains(entryId));
+    const auto heapIndex = heapIndices[entryId];
+    const auto previousScore = heap[heapIndex].score;
+    heap[heapIndex].score = score;
+    if (score > previousScore) {
+        SiftUp(heapIndex);
+    } else {
+        SiftDown(heapIndex);
+    }
+}
+
+void Agenda::Remove(EntryId entryId) {
+    assert(Contains(entryId));
+    const auto heapIndex = heapIndices[entryId];
+    heapIndices[entryId] = noHeapIndex;
+
+    auto last = std::move(heap.back());
+    heap.pop_back();
+    if (heapIndex == heap.size()) {
+        return;
+    }
+
+    const auto moveUp = IsBefore(last, heap[heapIndex]);
+    Place(heapIndex, std::move(last));
+    if (moveUp) {
+        SiftUp(heapIndex);
+    } else {
+        SiftDown(heapIndex);
+    }
+}
+
+Agenda::EntryId Agenda::Pop() {
+    const auto entryId = GetTop();
+    Remove(entryId);
+    return entryId;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool Agenda::Contains(EntryId entryId) const {
+    return entryId < heapIndices.size() && heapIndices[entryId] != noHeapIndex;
+}
+
+Agenda::EntryId Agenda::GetTop() const {
+    assert(!heap.empty());
+    return heap.front().entryId;
+}
+
+double Agenda::GetScore(EntryId entryId) const {
+    assert(Contains(entryId));
+    return heap[heapIndices[entryId]].score;
+}
+
+bool Agenda::IsEmpty() const {
+    return heap.empty();
+}
+
+std::size_t Agenda::GetSize() const {
+    return heap.size();
+}
+
+} // namespace blackboard
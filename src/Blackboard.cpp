@@ -3,10 +3,15 @@
 
 #include "Blackboard/Blackboard.h"
 
+#include <algorithm>
 #include <cassert>
+#include <exception>
+#include <iterator>
 
 namespace blackboard {
 
+using InvocationResult = Blackboard::InvocationResult;
+using DispatchResult = Blackboard::DispatchResult;
 using UnhandledEventException = Blackboard::UnhandledEventException;
 using BlackboardException = Blackboard::BlackboardException;
 using BlackboardQueuedException = Blackboard::BlackboardQueuedException;
@@ -17,23 +22,76 @@ constexpr Titerator nextIterator(Titerator& i) {
     return ++j;
 }
 
+static Blackboard::EventID ToEventID(const Blackboard::Event& event) {
+    return event;
+}
+
+// Typed channels are identified only by their hash, so their handlers are not given an event ID.
+static Blackboard::EventID ToEventID(ChannelID) {
+    return {};
+}
+
+static std::size_t HashEventKey(Blackboard::EventID eventId) {
+    return std::hash<Blackboard::EventID>{}(eventId);
+}
+
+static std::size_t HashEventKey(ChannelID channelId) {
+    return static_cast<std::size_t>(channelId);
+}
+
+#if !BLACKBOARD_EXCEPTIONS
+// Set by StopInvocationLoop() and consumed by the invocation loop of the calling thread, since
+// exceptions cannot be used to unwind the handler that requested the stop.
+static thread_local bool invocationLoopStopRequested = false;
+#endif // !BLACKBOARD_EXCEPTIONS
+
+// Invocation of a parallel-safe handler, which is set on the thread running it, since handlers of
+// the same group run concurrently and cannot share currentlyInvokedHandlerId.
+struct ParallelInvocation {
+    const Blackboard* blackboard;
+    std::thread::id threadIdDispatching;
+    EventHandlerUniqueId eventHandlerId;
+    bool removedItself;
+};
+
+static thread_local ParallelInvocation* currentParallelInvocation = nullptr;
+
+// Whether an event is being dispatched by the thread waiting for the parallel-safe handler running
+// on this thread, in which case dispatching it again would deadlock.
+static bool IsDispatchedByWaitingThread(const Blackboard* blackboard,
+                                        std::thread::id threadIdPostedBy) {
+    return currentParallelInvocation && currentParallelInvocation->blackboard == blackboard &&
+           currentParallelInvocation->threadIdDispatching == threadIdPostedBy;
+}
+
 //--------------------------------------------------------------------------------------------------
 
 Blackboard::Blackboard() : owner(GetThisThreadId()),
                            currentQueuedEvents(&queuedEventsFirst),
                            nextQueuedEvents(&queuedEventsSecond),
+                           nextQueuedEventSequence(0),
+                           cancelledQueuedEventCount(0),
                            processingQueuedEvents(false),
                            eventsUnderProcessingSemaphore(0),
                            currentlyInvokedHandlerId(0),
                            currentlyInvokedHandlerAutoRemoved(false),
-                           currentlyInvokedHandlerRemovedItself(false) {}
-
-Blackboard::~Blackboard() = default;
+                           currentlyInvokedHandlerRemovedItself(false),
+                           overwrittenDeadLetters(0),
+                           deadLettersEnabled(false),
+                           retainedEventCount(0),
+                           executor(nullptr),
+                           pendingAsyncEventHandlers(0) {}
+
+Blackboard::~Blackboard() {
+    // Pending async handlers still refer to the blackboard, in order to report their completion.
+    std::unique_lock<std::mutex> lock(asyncEventHandlersMutex);
+    asyncEventHandlersCondition.wait(lock, [this] { return pendingAsyncEventHandlers == 0; });
+}
 
 //--------------------------------------------------------------------------------------------------
 
 EventHandlerUniqueId
-Blackboard::CalculateEventHandlerId(const Blackboard::EventHandler& eventHandler) const {
+Blackboard::CalculateEventHandlerId(const EventHandlerInvoker& eventHandler) const {
     return std::hash<uint64_t>{}(reinterpret_cast<uint64_t>(&eventHandler));
 }
 
@@ -55,48 +113,77 @@ void Blackboard::DecrementEventsUnderProcessingSemaphore() {
     assert(eventsUnderProcessingSemaphore >= 0);
 }
 
-EventHandlerUniqueId Blackboard::CreateEvent(EventID eventId, const EventHandler& eventHandler,
-                                             CallEventHandlerOnce callOnce) {
-    const auto& [iterator, success] = events.emplace(std::piecewise_construct,
-                                                     std::forward_as_tuple(eventId),
-                                                     std::forward_as_tuple());
-    if (!success) {
-        throw std::bad_alloc();
+EventHandlerUniqueId Blackboard::InsertEventHandler(EventHandlerList& eventHandlerList,
+                                                    EventHandlerContainer&& eventHandlerContainer,
+                                                    EventHandlerPriority priority) {
+    // Async handlers need the thread pool only if there is no executor to run them.
+    if (eventHandlerContainer.parallelSafe ||
+            (eventHandlerContainer.kind == EventHandlerKind::Async && !executor)) {
+        CreateThreadPool();
     }
 
-    auto& [event, eventContainer] = *iterator;
-    eventContainer.eventHandlerList = std::make_unique<EventHandlerList>();
-    eventContainer.eventHandlerList->push_back(EventHandlerContainer(eventHandler, callOnce));
-
-    auto& addedEventHandlerContainer = eventContainer.eventHandlerList->back();
+    // Handlers of equal priority are inserted after the existing ones, preserving their order.
+    auto& [_, addedEventHandlerContainer] =
+            *eventHandlerList.emplace(priority, std::move(eventHandlerContainer));
     addedEventHandlerContainer.eventHandlerId =
             CalculateEventHandlerId(addedEventHandlerContainer.eventHandler);
 
     return addedEventHandlerContainer.eventHandlerId;
 }
 
-bool Blackboard::TryToRemoveEvent(Events::iterator& eventPair) {
+template <typename EventMap, typename EventKey>
+EventHandlerUniqueId Blackboard::CreateEvent(EventMap& eventMap, EventKey eventKey,
+                                             EventHandlerContainer&& eventHandlerContainer,
+                                             EventHandlerPriority priority) {
+    const auto& [iterator, success] = eventMap.emplace(std::piecewise_construct,
+                                                       std::forward_as_tuple(eventKey),
+                                                       std::forward_as_tuple());
+    if (!success) {
+        BLACKBOARD_THROW(std::bad_alloc());
+    }
+    eventFilter.Insert(HashEventKey(eventKey));
+
+    auto& [event, eventContainer] = *iterator;
+    eventContainer.eventHandlerList = std::make_unique<EventHandlerList>();
+
+    return InsertEventHandler(*eventContainer.eventHandlerList, std::move(eventHandlerContainer),
+                              priority);
+}
+
+template <typename EventMap>
+bool Blackboard::TryToRemoveEvent(EventMap& eventMap, typename EventMap::iterator& eventPair) {
     const std::lock_guard<std::mutex> lock(eventsUnderProcessingSemaphoreMutex);
     if (eventsUnderProcessingSemaphore == 0) {
-        events.erase(eventPair);
+        eventFilter.Remove(HashEventKey(eventPair->first));
+        eventMap.erase(eventPair);
         return true;
     }
     return false;
 }
 
-void Blackboard::CheckIfEventNeedsRemoval(Events::iterator& eventPair) {
+template <typename EventMap>
+void Blackboard::CheckIfEventNeedsRemoval(EventMap& eventMap,
+                                          typename EventMap::iterator& eventPair) {
     auto& [_, eventContainer] = *eventPair;
     if (eventContainer.deleted) {
-        TryToRemoveEvent(eventPair);
+        TryToRemoveEvent(eventMap, eventPair);
     } else if (eventContainer.eventHandlerList->empty()) {
         eventContainer.deleted = true;
-        TryToRemoveEvent(eventPair);
+        TryToRemoveEvent(eventMap, eventPair);
+    } else if (eventContainer.hasBatchEventHandlers) {
+        // Batch handlers may have just been removed, in which case events are no longer batched.
+        const auto& eventHandlerList = *eventContainer.eventHandlerList;
+        eventContainer.hasBatchEventHandlers =
+                std::any_of(eventHandlerList.begin(), eventHandlerList.end(),
+                            [](const auto& eventHandler) {
+            return eventHandler.second.kind == EventHandlerKind::Batch;
+        });
     }
 }
 
 void Blackboard::CheckIfHandlerNeedsRemoval(EventHandlerList& eventHandlerList,
                                             EventHandlerList::iterator* currentEventHandler) {
-    if ((*currentEventHandler)->callOnce) {
+    if ((*currentEventHandler)->second.callOnce) {
         currentlyInvokedHandlerAutoRemoved = true;
         *currentEventHandler = eventHandlerList.erase(*currentEventHandler);
         return;
@@ -109,191 +196,807 @@ void Blackboard::CheckIfHandlerNeedsRemoval(EventHandlerList& eventHandlerList,
     *currentEventHandler = nextIterator(*currentEventHandler);
 }
 
+bool Blackboard::AdmitEvent(EventID eventId, EventHandlerContainer& eventHandlerContainer,
+                            const void* eventContent) {
+    // Only handlers of events carrying an Object may have an invocation policy.
+    auto& invocationPolicyState = *eventHandlerContainer.invocationPolicyState;
+    const auto wasPending = invocationPolicyState.pending;
+    if (invocationPolicyState.AdmitEvent(*static_cast<const Object*>(eventContent),
+                                         std::chrono::steady_clock::now())) {
+        return true;
+    }
+
+    if (invocationPolicyState.pending && !wasPending) {
+        const std::lock_guard<std::mutex> lock(debouncedEventHandlersMutex);
+        debouncedEventHandlers.push_back({Event(eventId), eventHandlerContainer.eventHandlerId});
+    }
+    return false;
+}
+
+void Blackboard::DispatchDebouncedEvents(QueuedEventsReport* queuedEventsReport) {
+    std::vector<DebouncedEventHandler> dueEventHandlers;
+    {
+        const std::lock_guard<std::mutex> lock(debouncedEventHandlersMutex);
+        if (debouncedEventHandlers.empty()) {
+            return;
+        }
+        dueEventHandlers.swap(debouncedEventHandlers);
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<DebouncedEventHandler> pendingEventHandlers;
+
+    for (auto& dueEventHandler : dueEventHandlers) {
+        auto eventPair = events.find(dueEventHandler.event);
+        if (eventPair == events.end() || eventPair->second.deleted) {
+            continue;
+        }
+
+        auto& [_, eventContainer] = *eventPair;
+        // Events being dispatched by this thread, which is processing queued events from one of
+        // their handlers, or by the thread waiting for it, are left for the next drain, since
+        // waiting for them would never end.
+        if (GetThisThreadId() == eventContainer.threadIdPostedBy ||
+                IsDispatchedByWaitingThread(this, eventContainer.threadIdPostedBy)) {
+            pendingEventHandlers.push_back(std::move(dueEventHandler));
+            continue;
+        }
+
+        // The handler is looked up only once the event is owned, since its handlers may be
+        // removed while it is being dispatched.
+        std::unique_lock<std::mutex> eventMutexLock(eventContainer.eventMutex);
+        eventContainer.eventCondition.wait(eventMutexLock, [&eventContainer = eventContainer] {
+            return eventContainer.threadIdPostedBy == std::thread::id();
+        });
+        eventContainer.threadIdPostedBy = GetThisThreadId();
+        eventMutexLock.unlock();
+
+        const auto& currentEventHandlerList = eventContainer.eventHandlerList;
+        auto currentEventHandler = std::find_if(
+                currentEventHandlerList->begin(), currentEventHandlerList->end(),
+                [eventHandlerId = dueEventHandler.eventHandlerId](const auto& eventHandlerPair) {
+                    return eventHandlerPair.second.eventHandlerId == eventHandlerId;
+                });
+        if (eventContainer.deleted || currentEventHandler == currentEventHandlerList->end()) {
+            // The handler has been removed in the meantime, along with its pending event.
+        } else if (auto& eventHandlerContainer = currentEventHandler->second;
+                now < eventHandlerContainer.invocationPolicyState->pendingUntil) {
+            // Further events arrived during the quiet period, which has hence been extended.
+            pendingEventHandlers.push_back(std::move(dueEventHandler));
+        } else {
+            auto& invocationPolicyState = *eventHandlerContainer.invocationPolicyState;
+            invocationPolicyState.pending = false;
+
+            currentlyInvokedHandlerId = eventHandlerContainer.eventHandlerId;
+            auto currentEventHandlerFunction = eventHandlerContainer.eventHandler;
+            const auto& eventContent = invocationPolicyState.pendingEventContent;
+            if (InvokeStoppableEventHandler(currentEventHandlerFunction, dueEventHandler.event,
+                                            &eventContent) == InvocationResult::Error) {
+                ReportFailure(dueEventHandler.event, eventContent, DispatchResult::HandlerError);
+                if (queuedEventsReport->failedEvents++ == 0) {
+                    queuedEventsReport->firstFailure = DispatchResult::HandlerError;
+                    queuedEventsReport->firstFailedEvent = dueEventHandler.event;
+                    queuedEventsReport->firstFailedEventContent = &eventContent;
+                }
+            }
+            CheckIfHandlerNeedsRemoval(*currentEventHandlerList, &currentEventHandler);
+            currentlyInvokedHandlerId = 0;
+        }
+
+        eventContainer.threadIdPostedBy = std::thread::id();
+        CheckIfEventNeedsRemoval(events, eventPair);
+        eventContainer.eventCondition.notify_one();
+    }
+
+    if (!pendingEventHandlers.empty()) {
+        const std::lock_guard<std::mutex> lock(debouncedEventHandlersMutex);
+        debouncedEventHandlers.insert(debouncedEventHandlers.end(),
+                                      std::make_move_iterator(pendingEventHandlers.begin()),
+                                      std::make_move_iterator(pendingEventHandlers.end()));
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 
 EventHandlerUniqueId Blackboard::AddEventHandler(EventID eventId, const EventHandler& eventHandler,
-                                                 CallEventHandlerOnce callOnce) {
-    assert(GetThisThreadId() == owner);
+                                                 CallEventHandlerOnce callOnce,
+                                                 EventHandlerPriority priority,
+                                                 ParallelSafe parallelSafe) {
+    return AddEventHandlerInternal(eventId,
+                                   EventHandlerContainer(MakeEventHandlerInvoker(eventHandler),
+                                                         callOnce, parallelSafe),
+                                   priority);
+}
+
+EventHandlerUniqueId Blackboard::AddEventHandler(EventID eventId, EventHandler&& eventHandler,
+                                                 CallEventHandlerOnce callOnce,
+                                                 EventHandlerPriority priority,
+                                                 ParallelSafe parallelSafe) {
+    return AddEventHandlerInternal(
+            eventId,
+            EventHandlerContainer(MakeEventHandlerInvoker(std::move(eventHandler)), callOnce,
+                                  parallelSafe),
+            priority);
+}
+
+EventHandlerUniqueId
+Blackboard::AddEventHandlerInternal(EventID eventId, EventHandlerContainer&& eventHandlerContainer,
+                                    EventHandlerPriority priority) {
+    const auto eventHandlerId = AddEventHandlerInternal(events, eventId,
+                                                        std::move(eventHandlerContainer),
+                                                        priority);
+    ReplayRetainedEvents(eventId, eventHandlerId);
+    return eventHandlerId;
+}
 
+EventHandlerUniqueId
+Blackboard::AddBatchEventHandlerInternal(EventID eventId,
+                                         EventHandlerContainer&& eventHandlerContainer,
+                                         EventHandlerPriority priority) {
+    const auto eventHandlerId = AddEventHandlerInternal(events, eventId,
+                                                        std::move(eventHandlerContainer),
+                                                        priority);
     if (auto eventPair = events.find(eventId); eventPair != events.end()) {
+        auto& [_, eventContainer] = *eventPair;
+        eventContainer.hasBatchEventHandlers = true;
+    }
+    ReplayRetainedEvents(eventId, eventHandlerId);
+    return eventHandlerId;
+}
+
+void Blackboard::RemoveEventHandler(EventID eventId, EventHandlerUniqueId eventHandlerId) {
+    RemoveEventHandlerInternal(events, eventId, eventHandlerId);
+}
+
+void Blackboard::ClearEventHandlers(EventID eventId) {
+    ClearEventHandlersInternal(events, eventId);
+}
+
+EventHandlerUniqueId Blackboard::AddChannelHandler(ChannelID channelId, const void* channelType,
+                                                   EventHandlerContainer&& eventHandlerContainer,
+                                                   EventHandlerPriority priority) {
+    assert(GetThisThreadId() == owner);
+
+    const auto eventHandlerId = AddEventHandlerInternal(channels, channelId,
+                                                        std::move(eventHandlerContainer),
+                                                        priority);
+    if (auto channelPair = channels.find(channelId); channelPair != channels.end()) {
+        auto& [_, channelContainer] = *channelPair;
+        assert(!channelContainer.channelType || channelContainer.channelType == channelType);
+        channelContainer.channelType = channelType;
+    }
+    return eventHandlerId;
+}
+
+void Blackboard::RemoveChannelHandler(ChannelID channelId, EventHandlerUniqueId eventHandlerId) {
+    RemoveEventHandlerInternal(channels, channelId, eventHandlerId);
+}
+
+void Blackboard::ClearChannelHandlers(ChannelID channelId) {
+    ClearEventHandlersInternal(channels, channelId);
+}
+
+template <typename EventMap, typename EventKey>
+EventHandlerUniqueId
+Blackboard::AddEventHandlerInternal(EventMap& eventMap, EventKey eventKey,
+                                    EventHandlerContainer&& eventHandlerContainer,
+                                    EventHandlerPriority priority) {
+    assert(GetThisThreadId() == owner);
+
+    if (auto eventPair = eventMap.find(eventKey); eventPair != eventMap.end()) {
         auto& [_, eventContainer] = *eventPair;
         if (eventContainer.deleted) {
-            if (TryToRemoveEvent(eventPair)) {
-                return CreateEvent(eventId, eventHandler, callOnce);
+            if (TryToRemoveEvent(eventMap, eventPair)) {
+                return CreateEvent(eventMap, eventKey, std::move(eventHandlerContainer),
+                                   priority);
             }
             return 0;
         }
-        eventContainer.eventHandlerList->push_back(EventHandlerContainer(eventHandler, callOnce));
-
-        auto& addedEventHandlerContainer = eventContainer.eventHandlerList->back();
-        addedEventHandlerContainer.eventHandlerId =
-                CalculateEventHandlerId(addedEventHandlerContainer.eventHandler);
-
-        return addedEventHandlerContainer.eventHandlerId;
+        return InsertEventHandler(*eventContainer.eventHandlerList,
+                                  std::move(eventHandlerContainer), priority);
     }
 
-    return CreateEvent(eventId, eventHandler, callOnce);
+    return CreateEvent(eventMap, eventKey, std::move(eventHandlerContainer), priority);
 }
 
-void Blackboard::RemoveEventHandler(EventID eventId, EventHandlerUniqueId eventHandlerId) {
+template <typename EventMap, typename EventKey>
+void Blackboard::RemoveEventHandlerInternal(EventMap& eventMap, EventKey eventKey,
+                                            EventHandlerUniqueId eventHandlerId) {
+    if (currentParallelInvocation && currentParallelInvocation->blackboard == this &&
+            currentParallelInvocation->eventHandlerId == eventHandlerId) {
+        currentParallelInvocation->removedItself = true;
+        return;
+    }
     assert(GetThisThreadId() == owner);
 
-    auto eventPair = events.find(eventId);
-    if (eventPair == events.end()) {
+    auto eventPair = eventMap.find(eventKey);
+    if (eventPair == eventMap.end()) {
         assert(currentlyInvokedHandlerId == eventHandlerId && currentlyInvokedHandlerAutoRemoved);
         return;
     }
 
     auto& [_, eventContainer] = *eventPair;
     if (eventContainer.deleted) {
-        TryToRemoveEvent(eventPair);
+        TryToRemoveEvent(eventMap, eventPair);
         return;
     }
 
     const auto& currentEventHandlerList = eventContainer.eventHandlerList;
     for (auto eventHandler = currentEventHandlerList->begin();
             eventHandler != currentEventHandlerList->end(); ++eventHandler) {
-        if (eventHandler->eventHandlerId == eventHandlerId) {
+        if (eventHandler->second.eventHandlerId == eventHandlerId) {
             if (eventHandlerId == currentlyInvokedHandlerId) {
                 currentlyInvokedHandlerRemovedItself = true;
             } else {
                 currentEventHandlerList->erase(eventHandler);
             }
 
-            CheckIfEventNeedsRemoval(eventPair);
+            CheckIfEventNeedsRemoval(eventMap, eventPair);
             return;
         }
     }
 }
 
-void Blackboard::ClearEventHandlers(EventID eventId) {
+template <typename EventMap, typename EventKey>
+void Blackboard::ClearEventHandlersInternal(EventMap& eventMap, EventKey eventKey) {
     assert(GetThisThreadId() == owner);
 
-    auto eventPair = events.find(eventId);
-    if (eventPair == events.end()) {
+    auto eventPair = eventMap.find(eventKey);
+    if (eventPair == eventMap.end()) {
         return;
     }
 
     auto& [_, eventContainer] = *eventPair;
     if (eventContainer.deleted) {
-        TryToRemoveEvent(eventPair);
+        TryToRemoveEvent(eventMap, eventPair);
         return;
     }
 
     eventContainer.deleted = true;
-    TryToRemoveEvent(eventPair);
+    TryToRemoveEvent(eventMap, eventPair);
+}
+
+bool Blackboard::HasHandlers(EventID eventId) {
+    if (!eventFilter.MayContain(HashEventKey(eventId))) {
+        return false;
+    }
+    const auto eventPair = events.find(eventId);
+    return eventPair != events.end() && !eventPair->second.deleted;
+}
+
+bool Blackboard::HasChannelHandlers(ChannelID channelId) {
+    if (!eventFilter.MayContain(HashEventKey(channelId))) {
+        return false;
+    }
+    const auto channelPair = channels.find(channelId);
+    return channelPair != channels.end() && !channelPair->second.deleted;
 }
 
-void Blackboard::ProcessEvent(Events::iterator eventPair, const Object& eventContent) {
+template <typename EventMap>
+InvocationResult Blackboard::ProcessEvent(EventMap& eventMap,
+                                          typename EventMap::iterator eventPair,
+                                          const void* eventContent,
+                                          DispatchMode dispatchMode) {
     auto& [event, eventContainer] = *eventPair;
     eventContainer.threadIdPostedBy = GetThisThreadId();
 
+    const auto eventId = ToEventID(event);
     const auto& currentEventHandlerList = eventContainer.eventHandlerList;
     auto currentEventHandler = currentEventHandlerList->begin();
+    auto invocationResult = InvocationResult::Continue;
+    SharedObject sharedEventContent;
+
+    // Batch handlers of events dispatched immediately receive a batch of a single payload.
+    const auto singleEventContent = static_cast<const Object*>(eventContent);
+    const EventContentSpan singleEventContentBatch(&singleEventContent, 1);
+    const void* eventContentBatch = dispatchMode == DispatchMode::Batch
+                                    ? eventContent
+                                    : &singleEventContentBatch;
 
     while (currentEventHandler != currentEventHandlerList->end() && !eventContainer.deleted) {
-        currentlyInvokedHandlerId = currentEventHandler->eventHandlerId;
-        auto currentEventHandlerFunction = currentEventHandler->eventHandler; // intentionally copied
+        auto& [_, eventHandlerContainer] = *currentEventHandler;
+        const auto isBatch = eventHandlerContainer.kind == EventHandlerKind::Batch;
+        if (isBatch ? dispatchMode == DispatchMode::Queued : dispatchMode == DispatchMode::Batch) {
+            ++currentEventHandler;
+            continue;
+        }
 
-        try {
-            if (!currentEventHandlerFunction(event, eventContent)) {
-                CheckIfHandlerNeedsRemoval(*currentEventHandlerList, &currentEventHandler);
-                break;
+        if (eventHandlerContainer.kind == EventHandlerKind::Async) {
+            // Only events carrying an Object may have async handlers, which share a single copy.
+            if (!sharedEventContent) {
+                sharedEventContent =
+                        std::make_shared<const Object>(*static_cast<const Object*>(eventContent));
             }
-        } catch (const StopInvocationLoopException&) {
+            ExecuteAsyncEventHandler(eventHandlerContainer.eventHandler, eventId,
+                                     sharedEventContent);
+            invocationResult = InvocationResult::Continue;
+            CheckIfHandlerNeedsRemoval(*currentEventHandlerList, &currentEventHandler);
+        } else if (eventHandlerContainer.invocationPolicyState &&
+                   !AdmitEvent(eventId, eventHandlerContainer, eventContent)) {
+            invocationResult = InvocationResult::Continue;
+            ++currentEventHandler;
+        } else if (eventHandlerContainer.parallelSafe) {
+            invocationResult = InvokeParallelEventHandlers(*currentEventHandlerList,
+                                                           &currentEventHandler, eventId,
+                                                           eventContent);
+        } else {
+            currentlyInvokedHandlerId = eventHandlerContainer.eventHandlerId;
+            // Intentionally copied, since the handler may remove itself while being invoked.
+            auto currentEventHandlerFunction = eventHandlerContainer.eventHandler;
+            invocationResult = InvokeStoppableEventHandler(currentEventHandlerFunction, eventId,
+                                                           isBatch ? eventContentBatch
+                                                                   : eventContent);
             CheckIfHandlerNeedsRemoval(*currentEventHandlerList, &currentEventHandler);
-            break;
         }
 
-        CheckIfHandlerNeedsRemoval(*currentEventHandlerList, &currentEventHandler);
+        if (invocationResult != InvocationResult::Continue) {
+            break;
+        }
     }
 
     currentlyInvokedHandlerId = 0;
     eventContainer.threadIdPostedBy = std::thread::id();
 
-    CheckIfEventNeedsRemoval(eventPair);
+    CheckIfEventNeedsRemoval(eventMap, eventPair);
 
     eventContainer.eventCondition.notify_one();
+
+    return invocationResult;
+}
+
+InvocationResult Blackboard::InvokeStoppableEventHandler(const EventHandlerInvoker& eventHandler,
+                                                         EventID eventId,
+                                                         const void* eventContent) {
+#if BLACKBOARD_EXCEPTIONS
+    try {
+        return eventHandler(eventId, eventContent);
+    } catch (const StopInvocationLoopException&) {
+        return InvocationResult::Stop;
+    }
+#else
+    const auto invocationResult = eventHandler(eventId, eventContent);
+    if (invocationLoopStopRequested) {
+        invocationLoopStopRequested = false;
+        if (invocationResult == InvocationResult::Continue) {
+            return InvocationResult::Stop;
+        }
+    }
+    return invocationResult;
+#endif // BLACKBOARD_EXCEPTIONS
+}
+
+InvocationResult
+Blackboard::InvokeParallelEventHandlers(EventHandlerList& eventHandlerList,
+                                        EventHandlerList::iterator* currentEventHandler,
+                                        EventID eventId, const void* eventContent) {
+    std::vector<EventHandlerList::iterator> group;
+    auto groupEnd = *currentEventHandler;
+    for (; groupEnd != eventHandlerList.end() && groupEnd->second.parallelSafe; ++groupEnd) {
+        group.push_back(groupEnd);
+    }
+
+    std::vector<InvocationResult> invocationResults(group.size(), InvocationResult::Continue);
+    std::vector<ParallelInvocation> parallelInvocations(group.size());
+    for (std::size_t i = 0; i < group.size(); ++i) {
+        parallelInvocations[i] = {this, GetThisThreadId(), group[i]->second.eventHandlerId, false};
+    }
+#if BLACKBOARD_EXCEPTIONS
+    // Exceptions other than stops are rethrown on the posting thread, once the group has returned.
+    std::vector<std::exception_ptr> exceptions(group.size());
+#endif // BLACKBOARD_EXCEPTIONS
+
+    assert(threadPool);
+    threadPool->ParallelFor(group.size(), [&](std::size_t i) {
+        const auto& eventHandler = group[i]->second.eventHandler;
+        // Restored afterwards, since the handler may run on a thread invoking another group.
+        const auto previousParallelInvocation = currentParallelInvocation;
+        currentParallelInvocation = &parallelInvocations[i];
+#if BLACKBOARD_EXCEPTIONS
+        try {
+            invocationResults[i] = InvokeStoppableEventHandler(eventHandler, eventId,
+                                                               eventContent);
+        } catch (...) {
+            exceptions[i] = std::current_exception();
+        }
+#else
+        invocationResults[i] = InvokeStoppableEventHandler(eventHandler, eventId, eventContent);
+#endif // BLACKBOARD_EXCEPTIONS
+        currentParallelInvocation = previousParallelInvocation;
+    });
+
+    // Results are combined in invocation order, as if the group had been invoked serially.
+    auto invocationResult = InvocationResult::Continue;
+    for (std::size_t i = 0; i < group.size(); ++i) {
+        if (invocationResult == InvocationResult::Continue) {
+            invocationResult = invocationResults[i];
+        }
+        if (group[i]->second.callOnce || parallelInvocations[i].removedItself) {
+            eventHandlerList.erase(group[i]);
+        }
+    }
+    *currentEventHandler = groupEnd;
+
+#if BLACKBOARD_EXCEPTIONS
+    for (const auto& exception : exceptions) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+#endif // BLACKBOARD_EXCEPTIONS
+
+    return invocationResult;
+}
+
+void Blackboard::CreateThreadPool() {
+    std::call_once(threadPoolCreated, [this] {
+        threadPool = std::make_unique<ThreadPool>(ThreadPool::GetDefaultThreadCount());
+    });
+}
+
+Executor& Blackboard::GetExecutor() {
+    if (executor) {
+        return *executor;
+    }
+    // Async handlers added while an executor was set may outlive it.
+    CreateThreadPool();
+    return *threadPool;
+}
+
+void Blackboard::ExecuteAsyncEventHandler(const EventHandlerInvoker& eventHandler,
+                                          EventID eventId, const SharedObject& eventContent) {
+    {
+        const std::lock_guard<std::mutex> lock(asyncEventHandlersMutex);
+        ++pendingAsyncEventHandlers;
+    }
+
+    // The event ID is copied, since the event may be removed before the handler is invoked. The
+    // handler is copied into a non-const capture, so that the task is nothrow movable and stored
+    // inline.
+    auto task = [this, eventHandler = eventHandler, event = Event(eventId),
+                 eventContent = eventContent]() mutable {
+        auto invocationResult = InvocationResult::Error;
+#if BLACKBOARD_EXCEPTIONS
+        try {
+            invocationResult = InvokeStoppableEventHandler(eventHandler, event, &eventContent);
+        } catch (...) {
+            invocationResult = InvocationResult::Error;
+        }
+#else
+        invocationResult = InvokeStoppableEventHandler(eventHandler, event, &eventContent);
+#endif // BLACKBOARD_EXCEPTIONS
+        CompleteAsyncEventHandler(std::move(event), std::move(eventContent), invocationResult);
+    };
+    static_assert(Executor::Task::storesInline<decltype(task)>,
+                  "Async event handler tasks must fit in the inline buffer of executor tasks");
+    GetExecutor().Execute(std::move(task));
 }
 
-void Blackboard::PostEventInternal(EventID eventId, const Object& eventContent, bool requiresHandler) {
+void Blackboard::CompleteAsyncEventHandler(Event&& event, SharedObject&& eventContent,
+                                           InvocationResult invocationResult) {
+    const std::lock_guard<std::mutex> lock(asyncEventHandlersMutex);
+    if (invocationResult == InvocationResult::Error) {
+        failedAsyncEventHandlers.push_back({std::move(event), std::move(eventContent)});
+    }
+    if (--pendingAsyncEventHandlers == 0) {
+        asyncEventHandlersCondition.notify_all();
+    }
+}
+
+void Blackboard::ReportAsyncEventHandlerFailures() {
+    std::vector<FailedAsyncEventHandler> failures;
+    {
+        const std::lock_guard<std::mutex> lock(asyncEventHandlersMutex);
+        failures.swap(failedAsyncEventHandlers);
+    }
+    for (const auto& failure : failures) {
+        ReportFailure(failure.event, *failure.eventContent, DispatchResult::HandlerError);
+    }
+}
+
+void Blackboard::SetExecutor(Executor* executor) {
+    assert(GetThisThreadId() == owner);
+    this->executor = executor;
+}
+
+void Blackboard::WaitForAsyncEventHandlers() {
+    {
+        std::unique_lock<std::mutex> lock(asyncEventHandlersMutex);
+        asyncEventHandlersCondition.wait(lock, [this] { return pendingAsyncEventHandlers == 0; });
+    }
+    ReportAsyncEventHandlerFailures();
+}
+
+std::size_t Blackboard::GetPendingAsyncEventHandlerCount() {
+    const std::lock_guard<std::mutex> lock(asyncEventHandlersMutex);
+    return pendingAsyncEventHandlers;
+}
+
+template <typename EventMap>
+InvocationResult Blackboard::DispatchEvent(EventMap& eventMap,
+                                           typename EventMap::iterator eventPair,
+                                           const void* eventContent) {
+    auto& [_, eventContainer] = *eventPair;
+    if (GetThisThreadId() == eventContainer.threadIdPostedBy) {
+        return ProcessEvent(eventMap, eventPair, eventContent, DispatchMode::Immediate);
+    }
+
+    std::unique_lock<std::mutex> eventMutexLock(eventContainer.eventMutex);
+    eventContainer.eventCondition.wait(eventMutexLock, [&eventContainer = eventContainer] {
+        return eventContainer.threadIdPostedBy == std::thread::id();
+    });
+    return ProcessEvent(eventMap, eventPair, eventContent, DispatchMode::Immediate);
+}
+
+DispatchResult Blackboard::PostEventInternal(EventID eventId, const Object& eventContent,
+                                             bool requiresHandler) {
     IncrementEventsUnderProcessingSemaphore();
 
     auto eventPair = events.find(eventId);
+    if (eventPair != events.end() &&
+            IsDispatchedByWaitingThread(this, eventPair->second.threadIdPostedBy)) {
+        DecrementEventsUnderProcessingSemaphore();
+        // Copied, since the caller does not keep the payload alive until it is dispatched, and
+        // retained once dispatched, along with the rest of the queued events.
+        auto ownedEventContent = std::make_shared<const Object>(eventContent);
+        PostQueuedEventInternal(eventId, *ownedEventContent, ownedEventContent,
+                                requiresHandler ? QueuedEvent::RequiresHandler::Yes
+                                                : QueuedEvent::RequiresHandler::No,
+                                QueuedEvent::IsException::No, QueuedEventPriority::Normal,
+                                noDeadline, noTimeToLive);
+        return DispatchResult::Success;
+    }
+
+    RetainEvent(eventId, eventContent);
     if (eventPair == events.end()) {
         DecrementEventsUnderProcessingSemaphore();
+        CaptureDeadLetter(eventId, eventContent, GetThisThreadId());
         if (requiresHandler) {
-            throw UnhandledEventException(eventId, eventContent);
+            return ReportFailure(eventId, eventContent, DispatchResult::UnhandledEvent);
         }
-        return;
+        return DispatchResult::Success;
     }
 
     auto& [_, eventContainer] = *eventPair;
     if (eventContainer.deleted) {
         DecrementEventsUnderProcessingSemaphore();
+        CaptureDeadLetter(eventId, eventContent, GetThisThreadId());
+        auto dispatchResult = DispatchResult::Success;
         if (requiresHandler) {
-            auto unhandledEventException = UnhandledEventException(eventId, eventContent);
-            TryToRemoveEvent(eventPair);
-            throw unhandledEventException;
+            dispatchResult = ReportFailure(eventId, eventContent, DispatchResult::UnhandledEvent);
         }
-        TryToRemoveEvent(eventPair);
+        TryToRemoveEvent(events, eventPair);
+        return dispatchResult;
+    }
+
+    const auto invocationResult = DispatchEvent(events, eventPair, &eventContent);
+
+    DecrementEventsUnderProcessingSemaphore();
+
+    if (invocationResult == InvocationResult::Error) {
+        return ReportFailure(eventId, eventContent, DispatchResult::HandlerError);
+    }
+    return DispatchResult::Success;
+}
+
+void Blackboard::PostChannelEvent(ChannelID channelId, const void* channelType,
+                                  const void* eventContent) {
+    IncrementEventsUnderProcessingSemaphore();
+
+    auto channelPair = channels.find(channelId);
+    if (channelPair == channels.end()) {
+        DecrementEventsUnderProcessingSemaphore();
         return;
     }
 
-    if (GetThisThreadId() == eventContainer.threadIdPostedBy) {
-        ProcessEvent(eventPair, eventContent);
-    } else {
-        std::unique_lock<std::mutex> eventMutexLock(eventContainer.eventMutex);
-        eventContainer.eventCondition.wait(eventMutexLock,
-                                           [&eventContainer = eventContainer] {
-            return eventContainer.threadIdPostedBy == std::thread::id();
-        });
-        ProcessEvent(eventPair, eventContent);
+    auto& [_, channelContainer] = *channelPair;
+    assert(channelContainer.channelType == channelType);
+    if (channelContainer.deleted) {
+        DecrementEventsUnderProcessingSemaphore();
+        TryToRemoveEvent(channels, channelPair);
+        return;
+    }
+
+    // Channel events cannot be queued, unlike events, so they are dropped instead of deadlocking.
+    if (IsDispatchedByWaitingThread(this, channelContainer.threadIdPostedBy)) {
+        assert("Parallel-safe handlers cannot post channel events being dispatched!" && false);
+        DecrementEventsUnderProcessingSemaphore();
+        return;
     }
 
+    DispatchEvent(channels, channelPair, eventContent);
+
     DecrementEventsUnderProcessingSemaphore();
 }
 
 void Blackboard::PostEvent(EventID eventId, const Object& eventContent) {
-    PostEventInternal(eventId, eventContent, false);
+    ThrowOnFailure(eventId, eventContent, PostEventInternal(eventId, eventContent, false));
 }
 
 void Blackboard::PostEventRequiringHandler(EventID eventId, const Object& eventContent) {
-    PostEventInternal(eventId, eventContent, true);
+    ThrowOnFailure(eventId, eventContent, PostEventInternal(eventId, eventContent, true));
 }
 
 void Blackboard::PostException(EventID eventId, const Object& eventContent) {
-    throw BlackboardException(eventId, eventContent);
+    ThrowOnFailure(eventId, eventContent,
+                   ReportFailure(eventId, eventContent, DispatchResult::ExceptionPosted));
+}
+
+DispatchResult Blackboard::TryPostEvent(EventID eventId, const Object& eventContent) {
+    return PostEventInternal(eventId, eventContent, false);
+}
+
+DispatchResult Blackboard::TryPostEventRequiringHandler(EventID eventId,
+                                                        const Object& eventContent) {
+    return PostEventInternal(eventId, eventContent, true);
 }
 
-void Blackboard::PostQueuedEventInternal(EventID eventId,
-                                         const Object& eventContent,
-                                         QueuedEvent::RequiresHandler requiresHandler,
-                                         QueuedEvent::IsException isException) {
+Blackboard::QueuedEventTicket
+Blackboard::PostQueuedEventInternal(EventID eventId,
+                                    const Object& eventContent,
+                                    SharedObject ownedEventContent,
+                                    QueuedEvent::RequiresHandler requiresHandler,
+                                    QueuedEvent::IsException isException,
+                                    QueuedEventPriority priority,
+                                    Deadline deadline,
+                                    TimeToLive timeToLive) {
+    const auto expiry = timeToLive == noTimeToLive
+                        ? noDeadline
+                        : std::chrono::steady_clock::now() + timeToLive;
+
     const std::lock_guard<std::mutex> lock(processingQueuedEventsMutex);
-    if (processingQueuedEvents) {
-        nextQueuedEvents->emplace(eventId, eventContent, requiresHandler, isException);
+
+    uint32_t slot;
+    if (!freeCancellationSlots.empty()) {
+        slot = freeCancellationSlots.back();
+        freeCancellationSlots.pop_back();
     } else {
-        currentQueuedEvents->emplace(eventId, eventContent, requiresHandler, isException);
+        slot = static_cast<uint32_t>(cancellationSlots.size());
+        cancellationSlots.push_back({0, false, false});
     }
+    cancellationSlots[slot].queued = true;
+
+    auto& queuedEvents = processingQueuedEvents ? *nextQueuedEvents : *currentQueuedEvents;
+    queuedEvents.emplace_back(eventId, eventContent, std::move(ownedEventContent), requiresHandler,
+                              isException, priority, deadline, expiry, nextQueuedEventSequence++);
+    queuedEvents.back().cancellationSlot = slot;
+    std::push_heap(queuedEvents.begin(), queuedEvents.end(), QueuedEvent::IsScheduledAfter);
+    return static_cast<QueuedEventTicket>(cancellationSlots[slot].generation) << 32 | slot;
 }
 
-void Blackboard::PostQueuedEvent(EventID eventId, const Object& eventContent) {
-    PostQueuedEventInternal(eventId, eventContent, QueuedEvent::RequiresHandler::No,
-                            QueuedEvent::IsException::No);
+Blackboard::QueuedEventTicket
+Blackboard::PostQueuedEvent(EventID eventId, const Object& eventContent,
+                            QueuedEventPriority priority, Deadline deadline,
+                            TimeToLive timeToLive) {
+    return PostQueuedEventInternal(eventId, eventContent, nullptr,
+                                   QueuedEvent::RequiresHandler::No, QueuedEvent::IsException::No,
+                                   priority, deadline, timeToLive);
 }
 
-void Blackboard::PostQueuedEventRequiringHandler(EventID eventId, const Object& eventContent) {
-    PostQueuedEventInternal(eventId, eventContent, QueuedEvent::RequiresHandler::Yes,
-                            QueuedEvent::IsException::No);
+Blackboard::QueuedEventTicket
+Blackboard::PostQueuedEventRequiringHandler(EventID eventId, const Object& eventContent,
+                                            QueuedEventPriority priority, Deadline deadline,
+                                            TimeToLive timeToLive) {
+    return PostQueuedEventInternal(eventId, eventContent, nullptr,
+                                   QueuedEvent::RequiresHandler::Yes, QueuedEvent::IsException::No,
+                                   priority, deadline, timeToLive);
 }
 
-void Blackboard::PostQueuedException(EventID eventId, const Object& eventContent) {
-    PostQueuedEventInternal(eventId, eventContent, QueuedEvent::RequiresHandler::No,
-                            QueuedEvent::IsException::Yes);
+Blackboard::QueuedEventTicket
+Blackboard::PostQueuedException(EventID eventId, const Object& eventContent) {
+    return PostQueuedEventInternal(eventId, eventContent, nullptr,
+                                   QueuedEvent::RequiresHandler::No, QueuedEvent::IsException::Yes,
+                                   QueuedEventPriority::Normal, noDeadline, noTimeToLive);
 }
 
-void Blackboard::ProcessQueuedEvents() {
+void Blackboard::CancelQueuedEvent(QueuedEventTicket ticket) {
+    const auto slot = static_cast<uint32_t>(ticket);
+    const auto generation = static_cast<uint32_t>(ticket >> 32);
+
+    const std::lock_guard<std::mutex> lock(processingQueuedEventsMutex);
+    if (slot >= cancellationSlots.size()) {
+        return;
+    }
+    auto& cancellationSlot = cancellationSlots[slot];
+    if (cancellationSlot.queued && cancellationSlot.generation == generation &&
+            !cancellationSlot.cancelled) {
+        cancellationSlot.cancelled = true;
+        cancelledQueuedEventCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Blackboard::ReleaseCancellationSlots() {
+    for (const auto slot : poppedCancellationSlots) {
+        auto& cancellationSlot = cancellationSlots[slot];
+        if (cancellationSlot.cancelled) {
+            cancellationSlot.cancelled = false;
+            cancelledQueuedEventCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+        cancellationSlot.queued = false;
+        ++cancellationSlot.generation;
+        freeCancellationSlots.push_back(slot);
+    }
+    poppedCancellationSlots.clear();
+}
+
+bool Blackboard::CheckIfQueuedEventIsWithdrawn(const QueuedEvent& queuedEvent,
+                                               QueuedEventsReport* queuedEventsReport) {
+    if (cancelledQueuedEventCount.load(std::memory_order_relaxed) != 0) {
+        const std::lock_guard<std::mutex> lock(processingQueuedEventsMutex);
+        const auto cancelled = cancellationSlots[queuedEvent.cancellationSlot].cancelled;
+        // Also releases the slots of the events popped earlier, which may have been cancelled in
+        // the meantime, so that the drain stops locking as soon as possible.
+        ReleaseCancellationSlots();
+        if (cancelled) {
+            ++queuedEventsReport->cancelledEvents;
+            return true;
+        }
+    }
+
+    if (queuedEvent.expiry != noDeadline &&
+            std::chrono::steady_clock::now() > queuedEvent.expiry) {
+        ++queuedEventsReport->expiredEvents;
+        return true;
+    }
+    return false;
+}
+
+DispatchResult Blackboard::DispatchQueuedEvent(const QueuedEvent& queuedEvent, bool* isBatched) {
+    *isBatched = false;
+
+    if (queuedEvent.isException) {
+        return ReportFailure(queuedEvent.event, *queuedEvent.eventContent,
+                             DispatchResult::ExceptionPosted);
+    }
+
+    RetainEvent(queuedEvent.event, *queuedEvent.eventContent);
+
+    auto eventPair = events.find(queuedEvent.event);
+    if (eventPair == events.end() || eventPair->second.deleted) {
+        CaptureDeadLetter(queuedEvent.event, *queuedEvent.eventContent,
+                          queuedEvent.threadIdPostedBy);
+        if (queuedEvent.requiresHandler) {
+            return ReportFailure(queuedEvent.event, *queuedEvent.eventContent,
+                                 DispatchResult::UnhandledEvent);
+        }
+        return DispatchResult::Success;
+    }
+
+    // Read before dispatching, since the event may be removed by its handlers.
+    const auto hasBatchEventHandlers = eventPair->second.hasBatchEventHandlers;
+    const auto invocationResult = ProcessEvent(events, eventPair, queuedEvent.eventContent,
+                                               DispatchMode::Queued);
+    // Events stopped by a regular handler are withheld from batch handlers, as when not queued.
+    *isBatched = hasBatchEventHandlers && invocationResult == InvocationResult::Continue;
+    if (invocationResult == InvocationResult::Error) {
+        return ReportFailure(queuedEvent.event, *queuedEvent.eventContent,
+                             DispatchResult::HandlerError);
+    }
+    return DispatchResult::Success;
+}
+
+DispatchResult
+Blackboard::DispatchQueuedEventBatch(const Event& event,
+                                     const std::vector<const Object*>& eventContents) {
+    auto eventPair = events.find(event);
+    if (eventPair == events.end() || eventPair->second.deleted) {
+        return DispatchResult::Success;
+    }
+
+    const EventContentSpan eventContentBatch(eventContents.data(), eventContents.size());
+    if (ProcessEvent(events, eventPair, &eventContentBatch, DispatchMode::Batch) ==
+            InvocationResult::Error) {
+        return ReportFailure(event, *eventContents.front(), DispatchResult::HandlerError);
+    }
+    return DispatchResult::Success;
+}
+
+Blackboard::QueuedEventsReport
+Blackboard::ProcessQueuedEventsInternal(StopOnFailure stopOnFailure, Duration maxDuration,
+                                        std::size_t maxEvents) {
+    const auto endOfBudget = maxDuration == Duration::max()
+                             ? noDeadline
+                             : std::chrono::steady_clock::now() + maxDuration;
+
     IncrementEventsUnderProcessingSemaphore();
 
     if (GetThisThreadId() != threadIdProcessingQueuedEvents) {
@@ -304,45 +1007,372 @@ void Blackboard::ProcessQueuedEvents() {
 
         threadIdProcessingQueuedEvents = GetThisThreadId();
         processingQueuedEvents = true;
+        processedEventContents.clear();
     }
 
+    ReportAsyncEventHandlerFailures();
+
+    QueuedEventsReport queuedEventsReport;
+
+    const auto recordFailure = [&queuedEventsReport](DispatchResult dispatchResult,
+                                                     const Event& event,
+                                                     const Object* eventContent) {
+        if (dispatchResult != DispatchResult::Success &&
+                queuedEventsReport.failedEvents++ == 0) {
+            queuedEventsReport.firstFailure = dispatchResult;
+            queuedEventsReport.firstFailedEvent = event;
+            queuedEventsReport.firstFailedEventContent = eventContent;
+        }
+    };
+
+    DispatchDebouncedEvents(&queuedEventsReport);
+
+    // Payloads of consecutive events with the same ID, which are yet to be passed to their batch
+    // handlers.
+    Event batchedEvent;
+    std::vector<const Object*> batchedEventContents;
+
+    const auto dispatchBatchedEvents = [&] {
+        const auto dispatchResult = DispatchQueuedEventBatch(batchedEvent, batchedEventContents);
+        recordFailure(dispatchResult, batchedEvent, batchedEventContents.front());
+        batchedEventContents.clear();
+        return dispatchResult;
+    };
+
     while (!currentQueuedEvents->empty()) {
-        auto& queuedEvent = currentQueuedEvents->front();
-        if (queuedEvent.isException) {
-            auto blackboardException = BlackboardException(queuedEvent.event,
-                                                           queuedEvent.eventContent);
-            currentQueuedEvents->pop();
-            throw blackboardException;
+        if (queuedEventsReport.processedEvents == maxEvents ||
+                (endOfBudget != noDeadline && std::chrono::steady_clock::now() >= endOfBudget)) {
+            break;
         }
 
-        auto eventPair = events.find(queuedEvent.event);
-        if (eventPair == events.end() || eventPair->second.deleted) {
-            if (queuedEvent.requiresHandler) {
-                auto unhandledEventException = UnhandledEventException(queuedEvent.event,
-                                                                       queuedEvent.eventContent);
-                currentQueuedEvents->pop();
-                throw unhandledEventException;
+        if (!batchedEventContents.empty()) {
+            const auto& nextQueuedEvent = currentQueuedEvents->front();
+            if (nextQueuedEvent.isException || nextQueuedEvent.event != batchedEvent) {
+                if (dispatchBatchedEvents() != DispatchResult::Success &&
+                        stopOnFailure == StopOnFailure::Yes) {
+                    break;
+                }
             }
-            currentQueuedEvents->pop();
+        }
+
+        std::pop_heap(currentQueuedEvents->begin(), currentQueuedEvents->end(),
+                      QueuedEvent::IsScheduledAfter);
+        auto& queuedEvent = currentQueuedEvents->back();
+        poppedCancellationSlots.push_back(queuedEvent.cancellationSlot);
+
+        if (queuedEvent.ownedEventContent) {
+            processedEventContents.push_back(std::move(queuedEvent.ownedEventContent));
+        }
+
+        if (CheckIfQueuedEventIsWithdrawn(queuedEvent, &queuedEventsReport)) {
+            currentQueuedEvents->pop_back();
             continue;
         }
 
-        ProcessEvent(eventPair, queuedEvent.eventContent);
-        currentQueuedEvents->pop();
+        if (queuedEvent.deadline != noDeadline &&
+                std::chrono::steady_clock::now() > queuedEvent.deadline) {
+            ++queuedEventsReport.missedDeadlines;
+            ReportFailure(queuedEvent.event, *queuedEvent.eventContent,
+                          DispatchResult::DeadlineMissed);
+        }
+
+        bool isBatched = false;
+        const auto dispatchResult = DispatchQueuedEvent(queuedEvent, &isBatched);
+
+        ++queuedEventsReport.processedEvents;
+        recordFailure(dispatchResult, queuedEvent.event, queuedEvent.eventContent);
+
+        if (isBatched) {
+            if (batchedEventContents.empty()) {
+                batchedEvent = queuedEvent.event;
+            }
+            batchedEventContents.push_back(queuedEvent.eventContent);
+        }
+
+        currentQueuedEvents->pop_back();
+
+        if (dispatchResult != DispatchResult::Success && stopOnFailure == StopOnFailure::Yes) {
+            break;
+        }
+    }
+
+    if (!batchedEventContents.empty()) {
+        dispatchBatchedEvents();
     }
 
     processingQueuedEventsMutex.lock();
     processingQueuedEvents = false;
     threadIdProcessingQueuedEvents = std::thread::id();
-    std::swap(currentQueuedEvents, nextQueuedEvents);
+    if (currentQueuedEvents->empty()) {
+        std::swap(currentQueuedEvents, nextQueuedEvents);
+    } else {
+        // Merge the events posted in the meantime with the ones left behind by a failure or the
+        // budget, which remain ahead of them within the same priority and deadline.
+        for (auto& queuedEvent : *nextQueuedEvents) {
+            currentQueuedEvents->push_back(std::move(queuedEvent));
+            std::push_heap(currentQueuedEvents->begin(), currentQueuedEvents->end(),
+                           QueuedEvent::IsScheduledAfter);
+        }
+        nextQueuedEvents->clear();
+    }
+    ReleaseCancellationSlots();
+    queuedEventsReport.remainingEvents = currentQueuedEvents->size();
     processingQueuedEventsMutex.unlock();
 
     processingQueuedEventsCondition.notify_one();
     DecrementEventsUnderProcessingSemaphore();
+
+    return queuedEventsReport;
+}
+
+void Blackboard::ProcessQueuedEvents() {
+    ProcessQueuedEvents(Duration::max(), noEventLimit);
+}
+
+Blackboard::QueuedEventsReport Blackboard::ProcessQueuedEvents(Duration maxDuration,
+                                                               std::size_t maxEvents) {
+    const auto queuedEventsReport = ProcessQueuedEventsInternal(
+            BLACKBOARD_EXCEPTIONS ? StopOnFailure::Yes : StopOnFailure::No, maxDuration,
+            maxEvents);
+    if (queuedEventsReport.failedEvents != 0) {
+        ThrowOnFailure(queuedEventsReport.firstFailedEvent,
+                       *queuedEventsReport.firstFailedEventContent,
+                       queuedEventsReport.firstFailure);
+    }
+    return queuedEventsReport;
+}
+
+Blackboard::QueuedEventsReport Blackboard::TryProcessQueuedEvents() {
+    return ProcessQueuedEventsInternal(StopOnFailure::No, Duration::max(), noEventLimit);
+}
+
+Blackboard::QueuedEventsReport Blackboard::TryProcessQueuedEvents(Duration maxDuration,
+                                                                  std::size_t maxEvents) {
+    return ProcessQueuedEventsInternal(StopOnFailure::No, maxDuration, maxEvents);
+}
+
+void Blackboard::SetErrorHandler(const ErrorHandler& errorHandler) {
+    assert(GetThisThreadId() == owner);
+    this->errorHandler = errorHandler;
+}
+
+void Blackboard::EnableDeadLetters(std::size_t capacity) {
+    assert(GetThisThreadId() == owner);
+
+    const std::lock_guard<std::mutex> lock(deadLettersMutex);
+    deadLetters = capacity > 0 ? std::make_unique<DeadLetters>(capacity) : nullptr;
+    overwrittenDeadLetters = 0;
+    deadLettersEnabled = capacity > 0;
+}
+
+std::vector<Blackboard::DeadLetter> Blackboard::DrainDeadLetters() {
+    const std::lock_guard<std::mutex> lock(deadLettersMutex);
+    std::vector<DeadLetter> drainedDeadLetters;
+    if (deadLetters) {
+        drainedDeadLetters.reserve(deadLetters->GetSize());
+        while (!deadLetters->IsEmpty()) {
+            drainedDeadLetters.push_back(std::move(deadLetters->Front()));
+            deadLetters->Pop();
+        }
+    }
+    return drainedDeadLetters;
+}
+
+std::vector<Blackboard::DeadLetter> Blackboard::PeekDeadLetters() {
+    const std::lock_guard<std::mutex> lock(deadLettersMutex);
+    std::vector<DeadLetter> peekedDeadLetters;
+    if (deadLetters) {
+        peekedDeadLetters.reserve(deadLetters->GetSize());
+        for (std::size_t i = 0; i < deadLetters->GetSize(); ++i) {
+            peekedDeadLetters.push_back((*deadLetters)[i]);
+        }
+    }
+    return peekedDeadLetters;
+}
+
+std::size_t Blackboard::GetOverwrittenDeadLetterCount() {
+    const std::lock_guard<std::mutex> lock(deadLettersMutex);
+    return overwrittenDeadLetters;
+}
+
+void Blackboard::CaptureDeadLetter(EventID eventId, const Object& eventContent,
+                                   std::thread::id threadIdPostedBy) {
+    if (!deadLettersEnabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    const auto timestamp = std::chrono::steady_clock::now();
+
+    const std::lock_guard<std::mutex> lock(deadLettersMutex);
+    if (!deadLetters) {
+        return;
+    }
+    if (deadLetters->IsFull()) {
+        ++overwrittenDeadLetters;
+    }
+
+    auto& deadLetter = deadLetters->Push();
+    deadLetter.event = eventId;
+    deadLetter.eventContent = eventContent;
+    deadLetter.timestamp = timestamp;
+    deadLetter.threadIdPostedBy = threadIdPostedBy;
+}
+
+void Blackboard::RetainEvents(EventID eventId, std::size_t count) {
+    assert(GetThisThreadId() == owner);
+
+    const std::lock_guard<std::mutex> lock(retainedEventsMutex);
+    auto retainedEventPair = retainedEvents.find(eventId);
+    if (count == 0) {
+        if (retainedEventPair != retainedEvents.end()) {
+            retainedEvents.erase(retainedEventPair);
+            retainedEventCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    if (retainedEventPair == retainedEvents.end()) {
+        retainedEvents.emplace(Event(eventId), RingBuffer<Object>(count));
+        retainedEventCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Resizing keeps the newest payloads that fit.
+    auto& [_, eventContents] = *retainedEventPair;
+    RingBuffer<Object> resizedEventContents(count);
+    const auto size = eventContents.GetSize();
+    for (auto i = size > count ? size - count : 0; i < size; ++i) {
+        resizedEventContents.Push() = std::move(eventContents[i]);
+    }
+    eventContents = std::move(resizedEventContents);
+}
+
+std::vector<Object> Blackboard::PeekRetainedEvents(EventID eventId) {
+    const std::lock_guard<std::mutex> lock(retainedEventsMutex);
+    std::vector<Object> peekedEventContents;
+    if (auto retainedEventPair = retainedEvents.find(eventId);
+            retainedEventPair != retainedEvents.end()) {
+        const auto& [_, eventContents] = *retainedEventPair;
+        peekedEventContents.reserve(eventContents.GetSize());
+        for (std::size_t i = 0; i < eventContents.GetSize(); ++i) {
+            peekedEventContents.push_back(eventContents[i]);
+        }
+    }
+    return peekedEventContents;
+}
+
+void Blackboard::RetainEvent(EventID eventId, const Object& eventContent) {
+    if (retainedEventCount.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock(retainedEventsMutex);
+    if (auto retainedEventPair = retainedEvents.find(eventId);
+            retainedEventPair != retainedEvents.end()) {
+        auto& [_, eventContents] = *retainedEventPair;
+        eventContents.Push() = eventContent;
+    }
+}
+
+void Blackboard::ReplayRetainedEvents(EventID eventId, EventHandlerUniqueId eventHandlerId) {
+    if (retainedEventCount.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    // Copied, so that the lock is not held while the handler posts events.
+    auto eventContents = PeekRetainedEvents(eventId);
+    if (eventContents.empty()) {
+        return;
+    }
+
+    auto eventPair = events.find(eventId);
+    if (eventPair == events.end() || eventPair->second.deleted) {
+        return;
+    }
+    auto& [_, eventContainer] = *eventPair;
+    const auto eventHandlerPair = std::find_if(eventContainer.eventHandlerList->begin(),
+                                               eventContainer.eventHandlerList->end(),
+                                               [eventHandlerId](const auto& eventHandlerPair) {
+        return eventHandlerPair.second.eventHandlerId == eventHandlerId;
+    });
+    if (eventHandlerPair == eventContainer.eventHandlerList->end()) {
+        return;
+    }
+
+    // Copied, since the handler may add or remove handlers while being replayed to.
+    const auto& eventHandlerContainer = eventHandlerPair->second;
+    const auto eventHandler = eventHandlerContainer.eventHandler;
+    const auto kind = eventHandlerContainer.kind;
+    const auto callOnce = eventHandlerContainer.callOnce;
+    if (callOnce) {
+        eventContents.erase(eventContents.begin(), std::prev(eventContents.end()));
+    }
+
+    if (kind == EventHandlerKind::Async) {
+        for (auto& eventContent : eventContents) {
+            ExecuteAsyncEventHandler(eventHandler, eventId,
+                                     std::make_shared<const Object>(std::move(eventContent)));
+        }
+    } else if (kind == EventHandlerKind::Batch) {
+        std::vector<const Object*> eventContentPointers;
+        eventContentPointers.reserve(eventContents.size());
+        for (const auto& eventContent : eventContents) {
+            eventContentPointers.push_back(&eventContent);
+        }
+        const EventContentSpan eventContentBatch(eventContentPointers.data(),
+                                                 eventContentPointers.size());
+        if (InvokeStoppableEventHandler(eventHandler, eventId, &eventContentBatch) ==
+                InvocationResult::Error) {
+            ReportFailure(eventId, eventContents.front(), DispatchResult::HandlerError);
+        }
+    } else {
+        for (const auto& eventContent : eventContents) {
+            const auto invocationResult = InvokeStoppableEventHandler(eventHandler, eventId,
+                                                                      &eventContent);
+            if (invocationResult == InvocationResult::Error) {
+                ReportFailure(eventId, eventContent, DispatchResult::HandlerError);
+            }
+            if (invocationResult != InvocationResult::Continue) {
+                break;
+            }
+        }
+    }
+
+    if (callOnce && HasHandlers(eventId)) {
+        RemoveEventHandler(eventId, eventHandlerId);
+    }
+}
+
+DispatchResult Blackboard::ReportFailure(EventID eventId, const Object& eventContent,
+                                         DispatchResult failure) {
+    if (errorHandler) {
+        errorHandler(eventId, eventContent, failure);
+    }
+    return failure;
+}
+
+void Blackboard::ThrowOnFailure(EventID eventId, const Object& eventContent,
+                                DispatchResult failure) const {
+#if BLACKBOARD_EXCEPTIONS
+    switch (failure) {
+    case DispatchResult::Success:
+    case DispatchResult::DeadlineMissed:
+        break;
+    case DispatchResult::UnhandledEvent:
+        throw UnhandledEventException(eventId, eventContent);
+    case DispatchResult::HandlerError:
+    case DispatchResult::ExceptionPosted:
+        throw BlackboardException(eventId, eventContent);
+    }
+#endif // BLACKBOARD_EXCEPTIONS
 }
 
 void Blackboard::StopInvocationLoop() {
+#if BLACKBOARD_EXCEPTIONS
     throw StopInvocationLoopException();
+#else
+    invocationLoopStopRequested = true;
+#endif // BLACKBOARD_EXCEPTIONS
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -382,25 +1412,104 @@ const char* BlackboardQueuedException::what() const noexcept {
 //--------------------------------------------------------------------------------------------------
 
 Blackboard::QueuedEvent::QueuedEvent(EventID event, const Object& eventContent,
-                                     RequiresHandler requiresHandler, IsException isException)
-    : event(event), eventContent(eventContent),
+                                     SharedObject ownedEventContent,
+                                     RequiresHandler requiresHandler, IsException isException,
+                                     QueuedEventPriority priority, Deadline deadline,
+                                     Deadline expiry, uint64_t sequence)
+    : event(event), eventContent(&eventContent), ownedEventContent(std::move(ownedEventContent)),
+      threadIdPostedBy(std::this_thread::get_id()), deadline(deadline), expiry(expiry),
+      sequence(sequence), cancellationSlot(0), priority(priority),
       requiresHandler(requiresHandler == RequiresHandler::Yes),
       isException(isException == IsException::Yes) {}
 
+Blackboard::QueuedEvent::QueuedEvent(QueuedEvent&& from) noexcept = default;
+
+Blackboard::QueuedEvent&
+Blackboard::QueuedEvent::operator=(QueuedEvent&& from) noexcept = default;
+
 Blackboard::QueuedEvent::~QueuedEvent() = default;
 
+bool Blackboard::QueuedEvent::IsScheduledAfter(const QueuedEvent& first,
+                                               const QueuedEvent& second) {
+    if (first.priority != second.priority) {
+        return first.priority < second.priority;
+    }
+    if (first.deadline != second.deadline) {
+        return first.deadline > second.deadline;
+    }
+    return first.sequence > second.sequence;
+}
+
 //--------------------------------------------------------------------------------------------------
 
-Blackboard::EventHandlerContainer::EventHandlerContainer(const EventHandler& eventHandler,
-                                                         CallEventHandlerOnce callOnce)
-    : callOnce(callOnce == CallEventHandlerOnce::Yes), eventHandlerId(0),
-      eventHandler(eventHandler) {}
+Blackboard::EventHandlerContainer::EventHandlerContainer(EventHandlerInvoker&& eventHandler,
+                                                         CallEventHandlerOnce callOnce,
+                                                         ParallelSafe parallelSafe,
+                                                         EventHandlerKind kind)
+    : callOnce(callOnce == CallEventHandlerOnce::Yes),
+      parallelSafe(parallelSafe == ParallelSafe::Yes), kind(kind), eventHandlerId(0),
+      eventHandler(std::move(eventHandler)) {}
+
+Blackboard::EventHandlerContainer::EventHandlerContainer(EventHandlerContainer&& from) noexcept
+    : callOnce(from.callOnce), parallelSafe(from.parallelSafe), kind(from.kind),
+      eventHandlerId(from.eventHandlerId), eventHandler(std::move(from.eventHandler)),
+      invocationPolicyState(std::move(from.invocationPolicyState)) {}
 
 Blackboard::EventHandlerContainer::~EventHandlerContainer() = default;
 
 //--------------------------------------------------------------------------------------------------
 
-Blackboard::EventContainer::EventContainer() : eventHandlerList(), deleted(false) {}
+Blackboard::InvocationPolicy Blackboard::InvocationPolicy::RateLimit(double eventsPerSecond,
+                                                                     double burst) {
+    assert(eventsPerSecond > 0.0 && burst >= 1.0);
+    return {Kind::RateLimit, eventsPerSecond, burst, Duration::zero()};
+}
+
+Blackboard::InvocationPolicy Blackboard::InvocationPolicy::LeadingDebounce(Duration quietPeriod) {
+    return {Kind::LeadingDebounce, 0.0, 0.0, quietPeriod};
+}
+
+Blackboard::InvocationPolicy Blackboard::InvocationPolicy::TrailingDebounce(Duration quietPeriod) {
+    return {Kind::TrailingDebounce, 0.0, 0.0, quietPeriod};
+}
+
+Blackboard::InvocationPolicyState::InvocationPolicyState(const InvocationPolicy& invocationPolicy)
+    : invocationPolicy(invocationPolicy), tokens(invocationPolicy.burst),
+      lastRefill(std::chrono::steady_clock::now()), lastEvent(), pendingEventContent(),
+      pendingUntil(), pending(false) {}
+
+bool Blackboard::InvocationPolicyState::AdmitEvent(const Object& eventContent, Deadline now) {
+    switch (invocationPolicy.kind) {
+    case InvocationPolicy::Kind::RateLimit: {
+        const std::chrono::duration<double> elapsed = now - lastRefill;
+        tokens = std::min(invocationPolicy.burst,
+                          tokens + elapsed.count() * invocationPolicy.eventsPerSecond);
+        lastRefill = now;
+        if (tokens < 1.0) {
+            return false;
+        }
+        tokens -= 1.0;
+        return true;
+    }
+    case InvocationPolicy::Kind::LeadingDebounce: {
+        const auto isLeading = lastEvent == Deadline() ||
+                               now - lastEvent >= invocationPolicy.quietPeriod;
+        lastEvent = now;
+        return isLeading;
+    }
+    case InvocationPolicy::Kind::TrailingDebounce:
+        pendingEventContent = eventContent;
+        pendingUntil = now + invocationPolicy.quietPeriod;
+        pending = true;
+        return false;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Blackboard::EventContainer::EventContainer() : eventHandlerList(), channelType(nullptr),
+                                               hasBatchEventHandlers(false), deleted(false) {}
 
 Blackboard::EventContainer::~EventContainer() = default;
 
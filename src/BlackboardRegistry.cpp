@@ -56,7 +56,7 @@ Blackboard& BlackboardRegistry::CreateBlackboard(BlackboardId blackboardId) {
                                 std::forward_as_tuple(blackboardId),
                                 std::forward_as_tuple(std::make_unique<Blackboard>()));
     if (!success) {
-      throw std::bad_alloc();
+      BLACKBOARD_THROW(std::bad_alloc());
     }
 
     return *iterator->second;
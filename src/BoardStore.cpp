@@ -0,0 +1,422 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/BoardStore.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <string_view>
+
+namespace blackboard {
+
+// Marks the slot of a snapshot that is still choosing its version.
+static constexpr BoardStore::Version reservedSnapshotSlot =
+        std::numeric_limits<BoardStore::Version>::max();
+
+// Objects are hashed by address and NaN is not equal to itself, so neither can be found again.
+static bool IsIndexable(const Value& value) {
+    return !value.IsObject() && (!value.IsNumber() || !std::isnan(value.ToNumber()));
+}
+
+static bool IsOrderable(const Value& value) {
+    return value.IsString() || (value.IsNumber() && !std::isnan(value.ToNumber()));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+BoardStore::BoardStore(std::size_t bucketCount)
+    : buckets(bucketCount), bucketMask(bucketCount - 1), committedVersion(0), snapshotVersions(),
+      overflowSnapshotsMutex(), overflowSnapshotVersions(), writerMutex(), retiredVersions(),
+      removedKeys(), unlinkedKeys(), keyCount(0), indexes(), blackboard(nullptr),
+      changeEventId() {
+    assert(bucketCount > 0 && (bucketCount & bucketMask) == 0);
+    for (auto& bucket : buckets) {
+        bucket.store(nullptr, std::memory_order_relaxed);
+    }
+    for (auto& snapshotVersion : snapshotVersions) {
+        snapshotVersion.store(0, std::memory_order_relaxed);
+    }
+}
+
+BoardStore::BoardStore(Blackboard& blackboard, Blackboard::EventID changeEventId,
+                       std::size_t bucketCount)
+    : BoardStore(bucketCount) {
+    this->blackboard = &blackboard;
+    this->changeEventId = changeEventId;
+}
+
+BoardStore::~BoardStore() {
+    for (const auto& retiredVersion : retiredVersions) {
+        delete retiredVersion.superseded;
+    }
+    for (const auto& unlinkedKey : unlinkedKeys) {
+        delete unlinkedKey.keyNode->newest.load(std::memory_order_relaxed);
+        delete unlinkedKey.keyNode;
+    }
+
+    for (auto& bucket : buckets) {
+        auto keyNode = bucket.load(std::memory_order_relaxed);
+        while (keyNode) {
+            // Superseded versions that were still retained have been deleted above.
+            delete keyNode->newest.load(std::memory_order_relaxed);
+            delete std::exchange(keyNode, keyNode->next.load(std::memory_order_relaxed));
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+BoardStore::Version BoardStore::Put(const Value& key, const Object& entry) {
+    return Write(key, &entry);
+}
+
+BoardStore::Version BoardStore::Remove(const Value& key) {
+    return Write(key, nullptr);
+}
+
+BoardStore::Version BoardStore::Write(const Value& key, const Object* entry) {
+    std::unique_lock<std::mutex> writerMutexLock(writerMutex);
+
+    const auto keyNode = FindKeyNode(key);
+    if (!entry && (!keyNode || keyNode->newest.load(std::memory_order_relaxed)->deleted)) {
+        return committedVersion.load(std::memory_order_relaxed);
+    }
+
+    if (!indexes.empty()) {
+        const auto newest = keyNode ? keyNode->newest.load(std::memory_order_relaxed) : nullptr;
+        UpdateIndexes(key, newest && !newest->deleted ? &newest->entry : nullptr, entry);
+    }
+
+    const auto version = committedVersion.load(std::memory_order_relaxed) + 1;
+    const auto entryVersion = new EntryVersion{version, !entry, entry ? *entry : Object(),
+                                               nullptr};
+
+    if (keyNode) {
+        const auto superseded = keyNode->newest.load(std::memory_order_relaxed);
+        entryVersion->older.store(superseded, std::memory_order_relaxed);
+        keyNode->newest.store(entryVersion, std::memory_order_release);
+        retiredVersions.push_back({superseded, entryVersion});
+        if (!entry) {
+            removedKeys.push_back({keyNode, version});
+        }
+    } else {
+        auto& bucket = buckets[ValueHash()(key) & bucketMask];
+        bucket.store(new KeyNode{key, entryVersion, bucket.load(std::memory_order_relaxed)},
+                     std::memory_order_release);
+        ++keyCount;
+    }
+
+    committedVersion.store(version, std::memory_order_seq_cst);
+    ReclaimVersions();
+    writerMutexLock.unlock();
+
+    PostChange(key, version, entry);
+    return version;
+}
+
+BoardStore::KeyNode* BoardStore::FindKeyNode(const Value& key) const {
+    const auto& bucket = buckets[ValueHash()(key) & bucketMask];
+    for (auto keyNode = bucket.load(std::memory_order_acquire); keyNode;
+            keyNode = keyNode->next.load(std::memory_order_acquire)) {
+        if (keyNode->key == key) {
+            return keyNode;
+        }
+    }
+    return nullptr;
+}
+
+BoardStore::Version BoardStore::GetOldestPinnedVersion() const {
+    auto oldestPinnedVersion = committedVersion.load(std::memory_order_relaxed);
+    for (const auto& snapshotVersion : snapshotVersions) {
+        const auto pinnedVersion = snapshotVersion.load(std::memory_order_seq_cst);
+        if (pinnedVersion != 0 && pinnedVersion != reservedSnapshotSlot) {
+            oldestPinnedVersion = std::min(oldestPinnedVersion, pinnedVersion - 1);
+        }
+    }
+
+    const std::lock_guard<std::mutex> lock(overflowSnapshotsMutex);
+    if (!overflowSnapshotVersions.empty()) {
+        oldestPinnedVersion = std::min(oldestPinnedVersion, *overflowSnapshotVersions.begin());
+    }
+    return oldestPinnedVersion;
+}
+
+void BoardStore::ReclaimVersions() {
+    const auto oldestPinnedVersion = GetOldestPinnedVersion();
+
+    // Versions are retired in order, so each one has already been unlinked from older versions,
+    // and snapshots that can see its successor never look past it.
+    while (!retiredVersions.empty() &&
+            retiredVersions.front().superseding->version <= oldestPinnedVersion) {
+        const auto& retiredVersion = retiredVersions.front();
+        retiredVersion.superseding->older.store(nullptr, std::memory_order_relaxed);
+        delete retiredVersion.superseded;
+        retiredVersions.pop_front();
+    }
+
+    ReclaimKeys(oldestPinnedVersion);
+}
+
+void BoardStore::ReclaimKeys(Version oldestPinnedVersion) {
+    while (!unlinkedKeys.empty() && unlinkedKeys.front().version <= oldestPinnedVersion) {
+        const auto keyNode = unlinkedKeys.front().keyNode;
+        delete keyNode->newest.load(std::memory_order_relaxed);
+        delete keyNode;
+        unlinkedKeys.pop_front();
+    }
+
+    // Removed keys are unlinked only once their removal is all snapshots can see of them, by which
+    // point the versions they superseded have been reclaimed. Snapshots that pin the current
+    // version may still be traversing them, unlike the ones that pin any later version, since those
+    // find them unlinked.
+    while (!removedKeys.empty() && removedKeys.front().version <= oldestPinnedVersion) {
+        const auto [keyNode, version] = removedKeys.front();
+        removedKeys.pop_front();
+        // Keys that have been put again since, or removed once more, are not removed as of then.
+        if (keyNode->newest.load(std::memory_order_relaxed)->version != version) {
+            continue;
+        }
+
+        auto link = &buckets[ValueHash()(keyNode->key) & bucketMask];
+        while (link->load(std::memory_order_relaxed) != keyNode) {
+            link = &link->load(std::memory_order_relaxed)->next;
+        }
+        link->store(keyNode->next.load(std::memory_order_relaxed), std::memory_order_release);
+        unlinkedKeys.push_back({keyNode, committedVersion.load(std::memory_order_relaxed) + 1});
+        --keyCount;
+    }
+}
+
+void BoardStore::PostChange(const Value& key, Version version, const Object* entry) {
+    if (!blackboard) {
+        return;
+    }
+
+    blackboard->PostEvent(changeEventId, [&key, version, entry] {
+        Object change;
+        change.AddValue(Value{std::string_view("Key")}, key);
+        change.AddValue(Value{std::string_view("Version")}, Value{static_cast<double>(version)});
+        change.AddValue(Value{std::string_view("Deleted")}, Value{!entry});
+        if (entry) {
+            change.AddValue(Value{std::string_view("Entry")}, Value{*entry});
+        }
+        return change;
+    });
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void BoardStore::AddIndex(const Value& field, IndexKind kind) {
+    const std::lock_guard<std::mutex> lock(writerMutex);
+    assert(std::none_of(indexes.begin(), indexes.end(), [&field](const Index& index) {
+        return index.field == field;
+    }) && "Fields may be indexed only once!");
+
+    auto& index = indexes.emplace_back(Index{field, kind, {}, {}});
+    for (const auto& bucket : buckets) {
+        for (auto keyNode = bucket.load(std::memory_order_relaxed); keyNode;
+                keyNode = keyNode->next.load(std::memory_order_relaxed)) {
+            const auto newest = keyNode->newest.load(std::memory_order_relaxed);
+            if (newest->deleted) {
+                continue;
+            }
+            if (const auto value = newest->entry.GetValue(field)) {
+                IndexKey(index, *value, keyNode->key);
+            }
+        }
+    }
+}
+
+std::vector<Value> BoardStore::FindKeys(const Value& field, const Value& value) const {
+    const std::lock_guard<std::mutex> lock(writerMutex);
+    const auto& index = GetIndex(field);
+
+    const IndexedKeys* keys = nullptr;
+    if (index.kind == IndexKind::Hash && IsIndexable(value)) {
+        if (const auto keysPair = index.hashedKeys.find(value);
+                keysPair != index.hashedKeys.end()) {
+            keys = &keysPair->second;
+        }
+    } else if (index.kind == IndexKind::Ordered && IsOrderable(value)) {
+        if (const auto keysPair = index.orderedKeys.find(value);
+                keysPair != index.orderedKeys.end()) {
+            keys = &keysPair->second;
+        }
+    }
+    return keys ? std::vector<Value>(keys->begin(), keys->end()) : std::vector<Value>();
+}
+
+std::vector<Value> BoardStore::FindKeysInRange(const Value& field,
+                                               const std::optional<Value>& lower,
+                                               const std::optional<Value>& upper) const {
+    assert((lower || upper) && (!lower || IsOrderable(*lower)) && (!upper || IsOrderable(*upper)));
+    const std::lock_guard<std::mutex> lock(writerMutex);
+    const auto& index = GetIndex(field);
+    assert(index.kind == IndexKind::Ordered && "Range queries require an ordered index!");
+
+    std::vector<Value> keys;
+    if (lower && upper && !ValueLess()(*lower, *upper)) {
+        return keys;
+    }
+
+    // Numbers are ordered before strings, so open ranges stop at the boundary between the two.
+    const auto isNumber = (lower ? *lower : *upper).IsNumber();
+    const auto& orderedKeys = index.orderedKeys;
+    const auto begin = lower ? orderedKeys.lower_bound(*lower)
+                             : isNumber ? orderedKeys.begin()
+                                        : orderedKeys.lower_bound(Value{std::string_view()});
+    const auto end = upper ? orderedKeys.lower_bound(*upper)
+                           : isNumber ? orderedKeys.lower_bound(Value{std::string_view()})
+                                      : orderedKeys.end();
+    for (auto keysPair = begin; keysPair != end; ++keysPair) {
+        keys.insert(keys.end(), keysPair->second.begin(), keysPair->second.end());
+    }
+    return keys;
+}
+
+const BoardStore::Index& BoardStore::GetIndex(const Value& field) const {
+    const auto index = std::find_if(indexes.begin(), indexes.end(), [&field](const Index& index) {
+        return index.field == field;
+    });
+    assert(index != indexes.end() && "Field is not indexed!");
+    return *index;
+}
+
+void BoardStore::UpdateIndexes(const Value& key, const Object* superseded, const Object* entry) {
+    for (auto& index : indexes) {
+        const auto supersededValue = superseded ? superseded->GetValue(index.field) : std::nullopt;
+        const auto value = entry ? entry->GetValue(index.field) : std::nullopt;
+        if (supersededValue == value) {
+            continue;
+        }
+        if (supersededValue) {
+            UnindexKey(index, *supersededValue, key);
+        }
+        if (value) {
+            IndexKey(index, *value, key);
+        }
+    }
+}
+
+void BoardStore::IndexKey(Index& index, const Value& value, const Value& key) {
+    if (index.kind == IndexKind::Hash && IsIndexable(value)) {
+        index.hashedKeys[value].insert(key);
+    } else if (index.kind == IndexKind::Ordered && IsOrderable(value)) {
+        index.orderedKeys[value].insert(key);
+    }
+}
+
+void BoardStore::UnindexKey(Index& index, const Value& value, const Value& key) {
+    // Values are erased along with their last key, so that they do not accumulate.
+    if (index.kind == IndexKind::Hash && IsIndexable(value)) {
+        const auto keysPair = index.hashedKeys.find(value);
+        if (keysPair != index.hashedKeys.end() && keysPair->second.erase(key) &&
+                keysPair->second.empty()) {
+            index.hashedKeys.erase(keysPair);
+        }
+    } else if (index.kind == IndexKind::Ordered && IsOrderable(value)) {
+        const auto keysPair = index.orderedKeys.find(value);
+        if (keysPair != index.orderedKeys.end() && keysPair->second.erase(key) &&
+                keysPair->second.empty()) {
+            index.orderedKeys.erase(keysPair);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Returns maxSnapshots if all slots are taken.
+std::size_t BoardStore::AcquireSnapshotSlot() const {
+    for (std::size_t snapshotSlot = 0; snapshotSlot < maxSnapshots; ++snapshotSlot) {
+        Version freeSlot = 0;
+        if (snapshotVersions[snapshotSlot].compare_exchange_strong(freeSlot,
+                                                                   reservedSnapshotSlot)) {
+            return snapshotSlot;
+        }
+    }
+    return maxSnapshots;
+}
+
+BoardStore::Snapshot BoardStore::GetSnapshot() const {
+    const auto snapshotSlot = AcquireSnapshotSlot();
+
+    // Writers read the overflow versions under the mutex after committing, so a snapshot that
+    // pins the committed version under it is seen by every writer that may reclaim it.
+    if (snapshotSlot == maxSnapshots) {
+        const std::lock_guard<std::mutex> lock(overflowSnapshotsMutex);
+        const auto version = committedVersion.load(std::memory_order_seq_cst);
+        overflowSnapshotVersions.insert(version);
+        return Snapshot(*this, snapshotSlot, version);
+    }
+
+    // Writers may reclaim the versions a snapshot is about to pin, until they can see it pinned, so
+    // the version is pinned again whenever a write is committed in the meantime.
+    Version version;
+    do {
+        version = committedVersion.load(std::memory_order_seq_cst);
+        snapshotVersions[snapshotSlot].store(version + 1, std::memory_order_seq_cst);
+    } while (committedVersion.load(std::memory_order_seq_cst) != version);
+
+    return Snapshot(*this, snapshotSlot, version);
+}
+
+BoardStore::Version BoardStore::GetVersion() const {
+    return committedVersion.load(std::memory_order_acquire);
+}
+
+std::size_t BoardStore::GetRetainedVersionCount() const {
+    const std::lock_guard<std::mutex> lock(writerMutex);
+    return retiredVersions.size();
+}
+
+std::size_t BoardStore::GetKeyCount() const {
+    const std::lock_guard<std::mutex> lock(writerMutex);
+    return keyCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+BoardStore::Snapshot::Snapshot(const BoardStore& store, std::size_t snapshotSlot,
+                               Version version)
+    : store(&store), snapshotSlot(snapshotSlot), version(version) {}
+
+BoardStore::Snapshot::Snapshot(Snapshot&& from) noexcept
+    : store(std::exchange(from.store, nullptr)), snapshotSlot(from.snapshotSlot),
+      version(from.version) {}
+
+BoardStore::Snapshot::~Snapshot() {
+    if (!store) {
+        return;
+    } else if (snapshotSlot == maxSnapshots) {
+        const std::lock_guard<std::mutex> lock(store->overflowSnapshotsMutex);
+        store->overflowSnapshotVersions.erase(store->overflowSnapshotVersions.find(version));
+    } else {
+        store->snapshotVersions[snapshotSlot].store(0, std::memory_order_release);
+    }
+}
+
+const Object* BoardStore::Snapshot::Get(const Value& key) const {
+    const auto keyNode = store->FindKeyNode(key);
+    if (!keyNode) {
+        return nullptr;
+    }
+    const auto entryVersion = GetVisibleVersion(*keyNode);
+    return entryVersion ? &entryVersion->entry : nullptr;
+}
+
+BoardStore::Version BoardStore::Snapshot::GetVersion() const {
+    return version;
+}
+
+const BoardStore::EntryVersion*
+BoardStore::Snapshot::GetVisibleVersion(const KeyNode& keyNode) const {
+    auto entryVersion = keyNode.newest.load(std::memory_order_acquire);
+    while (entryVersion && entryVersion->version > version) {
+        entryVersion = entryVersion->older.load(std::memory_order_acquire);
+    }
+    return entryVersion && !entryVersion->deleted ? entryVersion : nullptr;
+}
+
+} // namespace blackboard
@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/DerivedValues.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace blackboard {
+
+DerivedValueReader::DerivedValueReader(DerivedValues& derivedValues,
+                                       std::vector<std::size_t>& dependencies)
+    : derivedValues(&derivedValues), dependencies(&dependencies) {}
+
+Value DerivedValueReader::Get(std::string_view name) {
+    const auto node = derivedValues->GetNode(name);
+    dependencies->push_back(node);
+    return derivedValues->Update(node);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+DerivedValues::DerivedValues()
+    : nodes(), nodesByName(), revision(1), computations(0), observedValues(),
+      notifyingObservers(false), observersPending(false), inputBindings() {}
+
+DerivedValues::~DerivedValues() {
+    for (const auto& inputBinding : inputBindings) {
+        inputBinding.blackboard->RemoveEventHandler(inputBinding.eventId,
+                                                    inputBinding.eventHandlerId);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void DerivedValues::SetInput(std::string_view name, const Value& value) {
+    auto& node = nodes[GetNode(name)];
+    assert(!node.computing);
+
+    if (!node.computation && node.value == value) {
+        return;
+    }
+
+    ++revision;
+    node.value = value;
+    node.computation = nullptr;
+    node.dependencies.clear();
+    node.changedAt = revision;
+    node.verifiedAt = revision;
+    node.depth = 0;
+
+    NotifyObservers();
+}
+
+void DerivedValues::BindInput(std::string_view name, Blackboard& blackboard, EventID eventId,
+                              const Value& field) {
+    const auto eventHandlerId = blackboard.AddEventHandler(eventId,
+            [this, name = std::string(name), field](EventID, const Object& eventContent) {
+        if (const auto value = eventContent.GetValue(field)) {
+            SetInput(name, *value);
+        }
+        return true;
+    }, Blackboard::CallEventHandlerOnce::No);
+    inputBindings.push_back({&blackboard, Blackboard::Event(eventId), eventHandlerId});
+}
+
+void DerivedValues::Define(std::string_view name, Computation&& computation) {
+    auto& node = nodes[GetNode(name)];
+    assert(!node.computing);
+
+    // The previous value is kept, so that the new computation is cut off if its result is equal.
+    ++revision;
+    node.computation = std::move(computation);
+    node.verifiedAt = 0;
+
+    NotifyObservers();
+}
+
+void DerivedValues::Observe(std::string_view name, Observer&& observer) {
+    observedValues.push_back({GetNode(name), std::move(observer), 0});
+    NotifyObservers();
+}
+
+Value DerivedValues::Get(std::string_view name) {
+    return Update(GetNode(name));
+}
+
+std::size_t DerivedValues::GetComputationCount() const {
+    return computations;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::size_t DerivedValues::GetNode(std::string_view name) {
+    if (const auto nodePair = nodesByName.find(name); nodePair != nodesByName.end()) {
+        return nodePair->second;
+    }
+
+    nodes.push_back({std::string(name), Value(), nullptr, {}, 0, revision, 0, false});
+    nodesByName.emplace(std::string(name), nodes.size() - 1);
+    return nodes.size() - 1;
+}
+
+const Value& DerivedValues::Update(std::size_t nodeIndex) {
+    auto& node = nodes[nodeIndex];
+    if (!node.computation || node.verifiedAt == revision) {
+        return node.value;
+    }
+    assert(!node.computing && "Derived values must not depend on themselves!");
+
+    if (node.verifiedAt == 0 || DependenciesChanged(nodeIndex)) {
+        Recompute(nodeIndex);
+    } else {
+        node.verifiedAt = revision;
+    }
+    return node.value;
+}
+
+bool DerivedValues::DependenciesChanged(std::size_t nodeIndex) {
+    auto& node = nodes[nodeIndex];
+    node.computing = true;
+
+    // Stops at the first change, since the computation may no longer read the rest.
+    auto changed = false;
+    for (const auto dependency : node.dependencies) {
+        Update(dependency);
+        if (nodes[dependency].changedAt > node.verifiedAt) {
+            changed = true;
+            break;
+        }
+    }
+
+    node.computing = false;
+    return changed;
+}
+
+void DerivedValues::Recompute(std::size_t nodeIndex) {
+    auto& node = nodes[nodeIndex];
+    node.computing = true;
+
+    std::vector<std::size_t> dependencies;
+    DerivedValueReader derivedValueReader(*this, dependencies);
+    auto value = node.computation(derivedValueReader);
+    ++computations;
+
+    node.computing = false;
+    node.depth = 0;
+    for (const auto dependency : dependencies) {
+        node.depth = std::max(node.depth, nodes[dependency].depth + 1);
+    }
+    node.dependencies = std::move(dependencies);
+
+    if (node.verifiedAt == 0 || value != node.value) {
+        node.value = std::move(value);
+        node.changedAt = revision;
+    }
+    node.verifiedAt = revision;
+}
+
+void DerivedValues::NotifyObservers() {
+    if (notifyingObservers) {
+        observersPending = true;
+        return;
+    }
+
+    notifyingObservers = true;
+    do {
+        observersPending = false;
+        for (const auto& observedValue : observedValues) {
+            Update(observedValue.node);
+        }
+        std::stable_sort(observedValues.begin(), observedValues.end(),
+                         [this](const ObservedValue& first, const ObservedValue& second) {
+            return nodes[first.node].depth < nodes[second.node].depth;
+        });
+
+        // Indexed, since observers may observe more values.
+        for (std::size_t i = 0; i < observedValues.size(); ++i) {
+            const auto& node = nodes[observedValues[i].node];
+            if (node.changedAt > observedValues[i].notifiedAt) {
+                observedValues[i].notifiedAt = node.changedAt;
+                const auto value = node.value;
+                auto observer = observedValues[i].observer;
+                observer(node.name, value);
+            }
+        }
+    } while (observersPending);
+    notifyingObservers = false;
+}
+
+} // namespace blackboard
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/EventFilter.h"
+
+#include <cassert>
+
+namespace blackboard {
+
+EventFilter::EventFilter() {
+    for (auto& counter : counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+EventFilter::~EventFilter() = default;
+
+//--------------------------------------------------------------------------------------------------
+
+std::size_t EventFilter::GetCounterIndex(std::size_t hash, std::size_t probe) noexcept {
+    // Derives the probes from the two halves of a single hash (Kirsch & Mitzenmacher).
+    const auto firstHash = static_cast<std::uint32_t>(hash);
+    const auto secondHash = static_cast<std::uint32_t>(static_cast<std::uint64_t>(hash) >> 32) | 1;
+    return (firstHash + probe * secondHash) % numCounters;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void EventFilter::Insert(std::size_t hash) noexcept {
+    for (std::size_t probe = 0; probe < numProbes; ++probe) {
+        [[maybe_unused]] const auto previousCount =
+                counters[GetCounterIndex(hash, probe)].fetch_add(1, std::memory_order_relaxed);
+        assert(previousCount != UINT16_MAX);
+    }
+}
+
+void EventFilter::Remove(std::size_t hash) noexcept {
+    for (std::size_t probe = 0; probe < numProbes; ++probe) {
+        [[maybe_unused]] const auto previousCount =
+                counters[GetCounterIndex(hash, probe)].fetch_sub(1, std::memory_order_relaxed);
+        assert(previousCount != 0);
+    }
+}
+
+bool EventFilter::MayContain(std::size_t hash) const noexcept {
+    for (std::size_t probe = 0; probe < numProbes; ++probe) {
+        if (counters[GetCounterIndex(hash, probe)].load(std::memory_order_relaxed) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace blackboard
@@ -0,0 +1,520 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/KnowledgeBase.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace blackboard {
+
+static bool ContainsFact(const std::vector<const KnowledgeBase::Fact*>& token,
+                         const KnowledgeBase::Fact& fact) {
+    return std::find(token.begin(), token.end(), &fact) != token.end();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+FactPattern::FactPattern(std::string_view factType) : factType(factType), tests(), bindings() {}
+
+FactPattern& FactPattern::Where(const Value& field, const Value& value) {
+    tests.emplace_back(field, value);
+    return *this;
+}
+
+FactPattern& FactPattern::Bind(const Value& field, std::string_view variable) {
+    bindings.emplace_back(field, std::string(variable));
+    return *this;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+KnowledgeBase::KnowledgeBase(RunAgendaAutomatically runAgendaAutomatically)
+    : facts(), nextFactId(0), alphaMemories(), alphaMemoriesByType(), knowledgeSources(),
+      activations(), freeActivationIds(), activationsByFact(), agenda(), activationScoring(),
+      runAgendaAutomatically(runAgendaAutomatically == RunAgendaAutomatically::Yes),
+      runningAgenda(false), retriedActivations(0) {}
+
+KnowledgeBase::~KnowledgeBase() = default;
+
+//--------------------------------------------------------------------------------------------------
+
+KnowledgeSourceId KnowledgeBase::AddKnowledgeSource(const std::vector<FactPattern>& conditions,
+                                                    KnowledgeSourceAction&& action) {
+    KnowledgeSource knowledgeSource;
+    knowledgeSource.action = std::move(action);
+    return AddKnowledgeSourceInternal(conditions, std::move(knowledgeSource));
+}
+
+KnowledgeSourceId
+KnowledgeBase::AddKnowledgeSource(const std::vector<FactPattern>& conditions,
+                                  TransactionalKnowledgeSourceAction&& action) {
+    KnowledgeSource knowledgeSource;
+    knowledgeSource.transactionalAction = std::move(action);
+    return AddKnowledgeSourceInternal(conditions, std::move(knowledgeSource));
+}
+
+KnowledgeSourceId
+KnowledgeBase::AddKnowledgeSourceInternal(const std::vector<FactPattern>& conditions,
+                                          KnowledgeSource&& newKnowledgeSource) {
+    assert(!conditions.empty());
+
+    const auto knowledgeSourceId = knowledgeSources.size();
+    auto& knowledgeSource = knowledgeSources.emplace_back(std::move(newKnowledgeSource));
+    knowledgeSource.betaMemories.resize(conditions.size());
+
+    // The first binding of each variable is the one the following ones are joined with.
+    std::unordered_map<std::string, std::pair<std::size_t, Value>> variables;
+    for (std::size_t i = 0; i < conditions.size(); ++i) {
+        auto alphaMemory = GetAlphaMemory(conditions[i]);
+        alphaMemory->successors.emplace_back(knowledgeSourceId, i);
+        knowledgeSource.alphaMemories.push_back(alphaMemory);
+
+        auto& joinTests = knowledgeSource.joinTests.emplace_back();
+        for (const auto& [field, variable] : conditions[i].bindings) {
+            const auto [binding, inserted] = variables.try_emplace(variable, i, field);
+            if (!inserted) {
+                joinTests.push_back({binding->second.first, binding->second.second, field});
+            }
+        }
+    }
+
+    // Match the facts asserted so far, extending each match of the first condition with the rest.
+    for (const auto fact : knowledgeSource.alphaMemories.front()->facts) {
+        ActivateRight(knowledgeSourceId, 0, *fact);
+    }
+    OnFactsChanged();
+
+    return knowledgeSourceId;
+}
+
+KnowledgeBase::AlphaMemory* KnowledgeBase::GetAlphaMemory(const FactPattern& condition) {
+    auto& alphaMemoriesOfType = alphaMemoriesByType[condition.factType];
+    for (const auto alphaMemory : alphaMemoriesOfType) {
+        if (alphaMemory->tests == condition.tests) {
+            return alphaMemory;
+        }
+    }
+
+    auto& alphaMemory = alphaMemories.emplace_back(std::make_unique<AlphaMemory>());
+    alphaMemory->factType = condition.factType;
+    alphaMemory->tests = condition.tests;
+    for (const auto& [_, fact] : facts) {
+        if (MatchesAlphaMemory(*alphaMemory, fact)) {
+            alphaMemory->facts.push_back(&fact);
+        }
+    }
+
+    alphaMemoriesOfType.push_back(alphaMemory.get());
+    return alphaMemory.get();
+}
+
+bool KnowledgeBase::MatchesAlphaMemory(const AlphaMemory& alphaMemory, const Fact& fact) {
+    if (fact.type != alphaMemory.factType) {
+        return false;
+    }
+    return std::all_of(alphaMemory.tests.begin(), alphaMemory.tests.end(),
+                       [&fact](const auto& test) {
+        const auto value = fact.content.GetValue(test.first);
+        return value && *value == test.second;
+    });
+}
+
+bool KnowledgeBase::MatchesJoinTests(const std::vector<JoinTest>& joinTests, const Token& token,
+                                     const Fact& fact) {
+    return std::all_of(joinTests.begin(), joinTests.end(), [&token, &fact](const auto& joinTest) {
+        // Variables bound twice within the same pattern are tested against the fact itself.
+        const auto& boundFact = joinTest.factIndex < token.size() ? *token[joinTest.factIndex]
+                                                                  : fact;
+        const auto value = boundFact.content.GetValue(joinTest.field);
+        const auto otherValue = fact.content.GetValue(joinTest.otherField);
+        return value && otherValue && *value == *otherValue;
+    });
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void KnowledgeBase::AddToNetwork(const Fact& fact) {
+    const auto alphaMemoriesOfType = alphaMemoriesByType.find(fact.type);
+    if (alphaMemoriesOfType == alphaMemoriesByType.end()) {
+        return;
+    }
+
+    for (const auto alphaMemory : alphaMemoriesOfType->second) {
+        if (!MatchesAlphaMemory(*alphaMemory, fact)) {
+            continue;
+        }
+
+        alphaMemory->facts.push_back(&fact);
+        // Later conditions go first, so that a fact matching several conditions of a knowledge
+        // source joins the matches it extends only once.
+        for (auto successor = alphaMemory->successors.rbegin();
+                successor != alphaMemory->successors.rend(); ++successor) {
+            ActivateRight(successor->first, successor->second, fact);
+        }
+    }
+}
+
+void KnowledgeBase::RemoveFromNetwork(const Fact& fact) {
+    const auto alphaMemoriesOfType = alphaMemoriesByType.find(fact.type);
+    if (alphaMemoriesOfType == alphaMemoriesByType.end()) {
+        return;
+    }
+
+    for (const auto alphaMemory : alphaMemoriesOfType->second) {
+        const auto alphaFact = std::find(alphaMemory->facts.begin(), alphaMemory->facts.end(),
+                                         &fact);
+        if (alphaFact == alphaMemory->facts.end()) {
+            continue;
+        }
+        alphaMemory->facts.erase(alphaFact);
+
+        for (const auto& [knowledgeSourceId, condition] : alphaMemory->successors) {
+            auto& betaMemories = knowledgeSources[knowledgeSourceId].betaMemories;
+            for (auto betaMemory = betaMemories.begin() + condition;
+                    betaMemory != betaMemories.end(); ++betaMemory) {
+                betaMemory->erase(std::remove_if(betaMemory->begin(), betaMemory->end(),
+                                                 [&fact](const Token& token) {
+                    return ContainsFact(token, fact);
+                }), betaMemory->end());
+            }
+        }
+    }
+
+    const auto factActivations = activationsByFact.find(&fact);
+    if (factActivations != activationsByFact.end()) {
+        // Copied, since releasing the activations removes them from the original.
+        const auto activationIds = factActivations->second;
+        for (const auto activationId : activationIds) {
+            agenda.Remove(activationId);
+            ReleaseActivation(activationId);
+        }
+    }
+}
+
+void KnowledgeBase::ActivateRight(KnowledgeSourceId knowledgeSourceId, std::size_t condition,
+                                  const Fact& fact) {
+    const auto& knowledgeSource = knowledgeSources[knowledgeSourceId];
+    const auto& joinTests = knowledgeSource.joinTests[condition];
+
+    if (condition == 0) {
+        if (MatchesJoinTests(joinTests, Token(), fact)) {
+            ExtendMatch(knowledgeSourceId, 0, Token{&fact});
+        }
+        return;
+    }
+
+    // Matches found while extending are only appended to later memories, so this one is stable.
+    for (const auto& leftToken : knowledgeSource.betaMemories[condition - 1]) {
+        if (!ContainsFact(leftToken, fact) && MatchesJoinTests(joinTests, leftToken, fact)) {
+            auto token = leftToken;
+            token.push_back(&fact);
+            ExtendMatch(knowledgeSourceId, condition, std::move(token));
+        }
+    }
+}
+
+void KnowledgeBase::ExtendMatch(KnowledgeSourceId knowledgeSourceId, std::size_t condition,
+                                Token&& token) {
+    auto& knowledgeSource = knowledgeSources[knowledgeSourceId];
+    const auto nextCondition = condition + 1;
+
+    if (nextCondition == knowledgeSource.alphaMemories.size()) {
+        AddActivation(knowledgeSourceId, token);
+        knowledgeSource.betaMemories[condition].push_back(std::move(token));
+        return;
+    }
+
+    for (const auto fact : knowledgeSource.alphaMemories[nextCondition]->facts) {
+        if (!ContainsFact(token, *fact) &&
+                MatchesJoinTests(knowledgeSource.joinTests[nextCondition], token, *fact)) {
+            auto nextToken = token;
+            nextToken.push_back(fact);
+            ExtendMatch(knowledgeSourceId, nextCondition, std::move(nextToken));
+        }
+    }
+    knowledgeSource.betaMemories[condition].push_back(std::move(token));
+}
+
+void KnowledgeBase::AddActivation(KnowledgeSourceId knowledgeSourceId, const Token& token) {
+    Agenda::EntryId activationId;
+    if (freeActivationIds.empty()) {
+        activationId = activations.size();
+        activations.push_back({knowledgeSourceId, token});
+    } else {
+        activationId = freeActivationIds.back();
+        freeActivationIds.pop_back();
+        activations[activationId] = {knowledgeSourceId, token};
+    }
+
+    for (const auto fact : token) {
+        activationsByFact[fact].push_back(activationId);
+    }
+
+    const FactSpan matchedFacts(token.data(), token.size());
+    agenda.Push(activationId, activationScoring ? activationScoring(knowledgeSourceId,
+                                                                    matchedFacts)
+                                                : 0.0);
+}
+
+void KnowledgeBase::ReleaseActivation(Agenda::EntryId activationId) {
+    for (const auto fact : activations[activationId].token) {
+        auto& factActivations = activationsByFact[fact];
+        factActivations.erase(std::find(factActivations.begin(), factActivations.end(),
+                                        activationId));
+        if (factActivations.empty()) {
+            activationsByFact.erase(fact);
+        }
+    }
+    freeActivationIds.push_back(activationId);
+}
+
+void KnowledgeBase::OnFactsChanged() {
+    if (runAgendaAutomatically) {
+        RunAgenda();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+FactId KnowledgeBase::AssertFact(std::string_view factType, const Object& content) {
+    const auto factId = ++nextFactId;
+    const auto& fact = facts.emplace(factId, Fact{factId, std::string(factType), content, 1})
+                            .first->second;
+    AddToNetwork(fact);
+    OnFactsChanged();
+    return factId;
+}
+
+void KnowledgeBase::UpdateFact(FactId factId, const Object& content) {
+    const auto factPair = facts.find(factId);
+    assert(factPair != facts.end());
+
+    auto& fact = factPair->second;
+    RemoveFromNetwork(fact);
+    fact.content = content;
+    ++fact.version;
+    AddToNetwork(fact);
+    OnFactsChanged();
+}
+
+void KnowledgeBase::RetractFact(FactId factId) {
+    const auto factPair = facts.find(factId);
+    if (factPair == facts.end()) {
+        return;
+    }
+
+    RemoveFromNetwork(factPair->second);
+    facts.erase(factPair);
+}
+
+const KnowledgeBase::Fact* KnowledgeBase::GetFact(FactId factId) const {
+    const auto factPair = facts.find(factId);
+    return factPair != facts.end() ? &factPair->second : nullptr;
+}
+
+std::size_t KnowledgeBase::GetFactCount() const {
+    return facts.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void KnowledgeBase::SetActivationScoring(ActivationScoring&& activationScoring) {
+    this->activationScoring = std::move(activationScoring);
+}
+
+std::size_t KnowledgeBase::RunAgenda(Duration maxDuration) {
+    // Activations caused by actions are run by the outermost call.
+    if (runningAgenda) {
+        return 0;
+    }
+
+    const auto endOfBudget = maxDuration == Duration::max()
+                             ? Blackboard::noDeadline
+                             : std::chrono::steady_clock::now() + maxDuration;
+
+    runningAgenda = true;
+    std::size_t ranActivations = 0;
+    while (!agenda.IsEmpty()) {
+        if (endOfBudget != Blackboard::noDeadline &&
+                std::chrono::steady_clock::now() >= endOfBudget) {
+            break;
+        }
+
+        KnowledgeSourceId knowledgeSourceId;
+        const auto token = PopActivation(&knowledgeSourceId);
+        RunActivation(knowledgeSourceId, token);
+        ++ranActivations;
+    }
+    runningAgenda = false;
+
+    return ranActivations;
+}
+
+std::size_t KnowledgeBase::RunAgendaInParallel(ThreadPool& threadPool, Duration maxDuration) {
+    if (runningAgenda) {
+        return 0;
+    }
+
+    const auto endOfBudget = maxDuration == Duration::max()
+                             ? Blackboard::noDeadline
+                             : std::chrono::steady_clock::now() + maxDuration;
+    const auto maxBatchSize = 4 * (threadPool.GetThreadCount() + 1);
+
+    runningAgenda = true;
+    std::size_t ranActivations = 0;
+    std::vector<SpeculativeActivation> batch;
+    while (!agenda.IsEmpty()) {
+        if (endOfBudget != Blackboard::noDeadline &&
+                std::chrono::steady_clock::now() >= endOfBudget) {
+            break;
+        }
+
+        // Activations of other knowledge sources may have side effects, so they run on their own.
+        if (!IsTransactional(activations[agenda.GetTop()].knowledgeSourceId)) {
+            KnowledgeSourceId knowledgeSourceId;
+            const auto token = PopActivation(&knowledgeSourceId);
+            RunActivation(knowledgeSourceId, token);
+            ++ranActivations;
+            continue;
+        }
+
+        batch.clear();
+        while (!agenda.IsEmpty() && batch.size() < maxBatchSize &&
+                IsTransactional(activations[agenda.GetTop()].knowledgeSourceId)) {
+            KnowledgeSourceId knowledgeSourceId;
+            auto token = PopActivation(&knowledgeSourceId);
+            auto transaction = BeginTransaction(token);
+            batch.push_back({knowledgeSourceId, std::move(token), std::move(transaction)});
+        }
+
+        // Facts are only read while the batch runs, since writes are deferred to the commits.
+        threadPool.ParallelFor(batch.size(), [this, &batch](std::size_t i) {
+            auto& activation = batch[i];
+            knowledgeSources[activation.knowledgeSourceId].transactionalAction(
+                    FactSpan(activation.token.data(), activation.token.size()),
+                    activation.transaction);
+        });
+
+        for (auto& activation : batch) {
+            // Activations whose matched facts have changed were withdrawn by the network, which
+            // has placed any match that still holds back on the agenda.
+            const auto& readSet = activation.transaction.readSet;
+            const auto isWithdrawn = std::any_of(readSet.begin(),
+                                                 readSet.begin() + activation.token.size(),
+                                                 [this](const auto& read) {
+                const auto fact = GetFact(read.first);
+                return !fact || fact->version != read.second;
+            });
+            if (isWithdrawn) {
+                continue;
+            }
+
+            if (!CommitTransaction(activation.transaction)) {
+                ++retriedActivations;
+                RunActivation(activation.knowledgeSourceId, activation.token);
+            }
+            ++ranActivations;
+        }
+    }
+    runningAgenda = false;
+
+    return ranActivations;
+}
+
+std::size_t KnowledgeBase::GetPendingActivationCount() const {
+    return agenda.GetSize();
+}
+
+std::size_t KnowledgeBase::GetRetriedActivationCount() const {
+    return retriedActivations;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+KnowledgeBase::Token KnowledgeBase::PopActivation(KnowledgeSourceId* knowledgeSourceId) {
+    const auto activationId = agenda.Pop();
+    ReleaseActivation(activationId);
+    // Moved out, since the action may add activations that reuse its slot.
+    *knowledgeSourceId = activations[activationId].knowledgeSourceId;
+    return std::move(activations[activationId].token);
+}
+
+bool KnowledgeBase::IsTransactional(KnowledgeSourceId knowledgeSourceId) const {
+    return static_cast<bool>(knowledgeSources[knowledgeSourceId].transactionalAction);
+}
+
+KnowledgeTransaction KnowledgeBase::BeginTransaction(const Token& token) const {
+    KnowledgeTransaction transaction(*this);
+    for (const auto fact : token) {
+        transaction.readSet.emplace_back(fact->id, fact->version);
+    }
+    return transaction;
+}
+
+bool KnowledgeBase::CommitTransaction(const KnowledgeTransaction& transaction) {
+    for (const auto& [factId, version] : transaction.readSet) {
+        const auto fact = GetFact(factId);
+        if ((fact ? fact->version : 0) != version) {
+            return false;
+        }
+    }
+
+    for (const auto& write : transaction.writes) {
+        switch (write.kind) {
+        case KnowledgeTransaction::WriteKind::Assert:
+            AssertFact(write.factType, write.content);
+            break;
+        case KnowledgeTransaction::WriteKind::Update:
+            if (GetFact(write.factId)) {
+                UpdateFact(write.factId, write.content);
+            }
+            break;
+        case KnowledgeTransaction::WriteKind::Retract:
+            RetractFact(write.factId);
+            break;
+        }
+    }
+    return true;
+}
+
+void KnowledgeBase::RunActivation(KnowledgeSourceId knowledgeSourceId, const Token& token) {
+    const auto& knowledgeSource = knowledgeSources[knowledgeSourceId];
+    const FactSpan matchedFacts(token.data(), token.size());
+    if (!knowledgeSource.transactionalAction) {
+        knowledgeSource.action(matchedFacts);
+        return;
+    }
+
+    // Nothing else runs in the meantime, so the commit cannot fail.
+    auto transaction = BeginTransaction(token);
+    knowledgeSource.transactionalAction(matchedFacts, transaction);
+    CommitTransaction(transaction);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+KnowledgeTransaction::KnowledgeTransaction(const KnowledgeBase& knowledgeBase)
+    : knowledgeBase(&knowledgeBase), readSet(), writes() {}
+
+const Object* KnowledgeTransaction::ReadFact(FactId factId) {
+    const auto fact = knowledgeBase->GetFact(factId);
+    readSet.emplace_back(factId, fact ? fact->version : 0);
+    return fact ? &fact->content : nullptr;
+}
+
+void KnowledgeTransaction::AssertFact(std::string_view factType, const Object& content) {
+    writes.push_back({WriteKind::Assert, 0, std::string(factType), content});
+}
+
+void KnowledgeTransaction::UpdateFact(FactId factId, const Object& content) {
+    ReadFact(factId);
+    writes.push_back({WriteKind::Update, factId, std::string(), content});
+}
+
+void KnowledgeTransaction::RetractFact(FactId factId) {
+    ReadFact(factId);
+    writes.push_back({WriteKind::Retract, factId, std::string(), Object()});
+}
+
+} // namespace blackboard
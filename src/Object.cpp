@@ -16,19 +16,21 @@ Object::~Object() = default;
 
 //--------------------------------------------------------------------------------------------------
 
+// Assigns the values in place, so that the nodes and buckets of the map are reused, unless this
+// object has been moved from.
 Object& Object::operator=(const Object& from) {
     if (this != &from) {
-        this->~Object();
-        new (this) Object(from);
+        if (values) {
+            *values = *from.values;
+        } else {
+            values = std::make_unique<Values>(*from.values);
+        }
     }
     return *this;
 }
 
 Object& Object::operator=(Object&& from) noexcept {
-    if (this != &from) {
-        this->~Object();
-        return *new (this) Object(from);
-    }
+    values.swap(from.values);
     return *this;
 }
 
@@ -72,4 +74,131 @@ Object& Object::RemoveValue(const Value& key) {
     return *this;
 }
 
+Object& Object::Clear() {
+    if (values) {
+        values->clear();
+    } else {
+        values = std::make_unique<Values>();
+    }
+    return *this;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::optional<Value> Object::GetValueAt(const KeyPath& keyPath) const {
+    if (const auto value = FindValueAt(keyPath)) {
+        return *value;
+    }
+    return {};
+}
+
+const Value* Object::FindValueAt(const KeyPath& keyPath) const {
+    const auto* object = this;
+    for (std::size_t i = 0; i < keyPath.size(); ++i) {
+        const auto iterator = object->values->find(keyPath[i]);
+        if (iterator == object->values->end()) {
+            return nullptr;
+        } else if (i + 1 == keyPath.size()) {
+            return &iterator->second;
+        } else if (!iterator->second.IsObject()) {
+            return nullptr;
+        }
+        object = iterator->second.GetObject();
+    }
+    return nullptr;
+}
+
+ObjectDelta Object::Diff(const Object& other) const {
+    KeyPath keyPath;
+    ObjectDelta delta;
+    DiffInto(other, &keyPath, &delta);
+    return delta;
+}
+
+ObjectDelta Object::Diff(const Object& other, const std::vector<KeyPath>& keyPaths) const {
+    // Values are compared in place, so that only the ones that differ are copied, into the delta.
+    ObjectDelta delta;
+    for (const auto& keyPath : keyPaths) {
+        const auto value = FindValueAt(keyPath);
+        const auto otherValue = other.FindValueAt(keyPath);
+        if (value && otherValue && value->IsObject() && otherValue->IsObject()) {
+            auto nestedKeyPath = keyPath;
+            value->GetObject()->DiffInto(*otherValue->GetObject(), &nestedKeyPath, &delta);
+        } else if (!otherValue) {
+            if (value) {
+                delta.push_back({keyPath, {}});
+            }
+        } else if (!value || *value != *otherValue) {
+            delta.push_back({keyPath, *otherValue});
+        }
+    }
+    return delta;
+}
+
+void Object::DiffInto(const Object& other, KeyPath* keyPath, ObjectDelta* delta) const {
+    for (const auto& [key, value] : *values) {
+        const auto otherIterator = other.values->find(key);
+        if (otherIterator == other.values->end()) {
+            keyPath->push_back(key);
+            delta->push_back({*keyPath, {}});
+            keyPath->pop_back();
+            continue;
+        }
+
+        const auto& otherValue = otherIterator->second;
+        if (value.IsObject() && otherValue.IsObject()) {
+            keyPath->push_back(key);
+            value.GetObject()->DiffInto(*otherValue.GetObject(), keyPath, delta);
+            keyPath->pop_back();
+        } else if (value != otherValue) {
+            keyPath->push_back(key);
+            delta->push_back({*keyPath, otherValue});
+            keyPath->pop_back();
+        }
+    }
+
+    for (const auto& [otherKey, otherValue] : *other.values) {
+        if (values->find(otherKey) == values->end()) {
+            keyPath->push_back(otherKey);
+            delta->push_back({*keyPath, otherValue});
+            keyPath->pop_back();
+        }
+    }
+}
+
+Object& Object::Patch(const ObjectDelta& delta) {
+    for (const auto& [keyPath, value] : delta) {
+        if (keyPath.empty()) {
+            continue;
+        }
+
+        auto* object = this;
+        for (std::size_t i = 0; i + 1 < keyPath.size(); ++i) {
+            auto iterator = object->values->find(keyPath[i]);
+            const auto exists = iterator != object->values->end();
+            if (!exists || !iterator->second.IsObject()) {
+                // Removing a value whose parent does not exist has no effect.
+                if (!value) {
+                    object = nullptr;
+                    break;
+                } else if (exists) {
+                    iterator->second.FromObject(Object());
+                } else {
+                    iterator = object->values->emplace(keyPath[i], Value(Object())).first;
+                }
+            }
+            object = iterator->second.GetObject();
+        }
+
+        if (!object) {
+            continue;
+        } else if (!value) {
+            object->RemoveValue(keyPath.back());
+        } else {
+            object->AddValue(keyPath.back(), *value);
+        }
+    }
+    return *this;
+}
+
 } // namespace blackboard
@@ -0,0 +1,369 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/SequenceDetector.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cassert>
+#include <chrono>
+#include <limits>
+#include <string_view>
+#include <utility>
+
+namespace blackboard {
+
+static constexpr auto noState = std::numeric_limits<std::size_t>::max();
+static constexpr auto noPartialMatch = std::numeric_limits<std::size_t>::max();
+
+//--------------------------------------------------------------------------------------------------
+
+SequencePattern::SequencePattern()
+    : steps(), negatedEventIds(), window(Duration::max()), keyField() {}
+
+SequencePattern& SequencePattern::Then(EventID eventId) {
+    std::sort(negatedEventIds.begin(), negatedEventIds.end());
+    steps.push_back({Event(eventId), std::move(negatedEventIds)});
+    negatedEventIds.clear();
+    return *this;
+}
+
+SequencePattern& SequencePattern::Without(EventID eventId) {
+    assert(!steps.empty() && "Patterns cannot start with a negation!");
+    negatedEventIds.emplace_back(eventId);
+    return *this;
+}
+
+SequencePattern& SequencePattern::Within(Duration window) {
+    assert(window > Duration::zero());
+    this->window = window;
+    return *this;
+}
+
+SequencePattern& SequencePattern::CorrelatedBy(const Value& keyField) {
+    this->keyField = keyField;
+    return *this;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+SequenceDetector::SequenceDetector(Blackboard& blackboard,
+                                   std::size_t maxPartialMatchesPerState)
+    : blackboard(blackboard), maxPartialMatchesPerState(maxPartialMatchesPerState), roots(),
+      states(), eventTransitions(), partialMatches(), freePartialMatches(), expiries(),
+      partialMatchCount(0), evictedPartialMatches(0) {
+    assert(maxPartialMatchesPerState > 0);
+}
+
+SequenceDetector::~SequenceDetector() {
+    for (const auto& [eventId, transitions] : eventTransitions) {
+        blackboard.RemoveEventHandler(eventId, transitions.eventHandlerId);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void SequenceDetector::AddPattern(const SequencePattern& pattern, EventID matchEventId) {
+    assert(!pattern.steps.empty() && pattern.negatedEventIds.empty());
+
+    auto state = roots[GetRoot(pattern)].state;
+    for (const auto& step : pattern.steps) {
+        state = GetState(state, step);
+    }
+    states[state].matchEventIds.emplace_back(matchEventId);
+}
+
+void SequenceDetector::Advance(Deadline now) {
+    while (!expiries.empty() && expiries.top().expiry < now) {
+        const auto expiry = expiries.top();
+        expiries.pop();
+
+        // Partial matches removed earlier leave their expiries behind, which are skipped.
+        if (partialMatches[expiry.partialMatch].generation == expiry.generation) {
+            RemovePartialMatch(expiry.partialMatch);
+            ++evictedPartialMatches;
+        }
+    }
+}
+
+std::size_t SequenceDetector::GetStateCount() const {
+    return states.size();
+}
+
+std::size_t SequenceDetector::GetPartialMatchCount() const {
+    return partialMatchCount;
+}
+
+std::size_t SequenceDetector::GetEvictedPartialMatchCount() const {
+    return evictedPartialMatches;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::size_t SequenceDetector::GetRoot(const SequencePattern& pattern) {
+    for (std::size_t root = 0; root < roots.size(); ++root) {
+        if (roots[root].window == pattern.window && roots[root].keyField == pattern.keyField) {
+            return root;
+        }
+    }
+
+    roots.push_back({pattern.window, pattern.keyField, states.size()});
+    states.push_back({roots.size() - 1, noState, 0, Event(), {}, {}, {}, {}, noPartialMatch,
+                      noPartialMatch, 0});
+    return roots.size() - 1;
+}
+
+std::size_t SequenceDetector::GetState(std::size_t parent, const SequencePattern::Step& step) {
+    for (const auto transition : states[parent].transitions) {
+        if (states[transition].eventId == step.eventId &&
+                states[transition].negatedEventIds == step.negatedEventIds) {
+            return transition;
+        }
+    }
+    assert(states[parent].transitions.size() < maxTransitions);
+
+    const auto state = states.size();
+    const auto transition = states[parent].transitions.size();
+    states.push_back({states[parent].root, parent, states[parent].depth + 1, step.eventId,
+                      step.negatedEventIds, {}, {}, {}, noPartialMatch, noPartialMatch, 0});
+    states[parent].transitions.push_back(state);
+
+    if (parent == roots[states[parent].root].state) {
+        GetEventTransitions(step.eventId).startingStates.push_back(state);
+    } else {
+        GetEventTransitions(step.eventId).advancingTransitions.emplace_back(parent, transition);
+    }
+    for (const auto& negatedEventId : step.negatedEventIds) {
+        GetEventTransitions(negatedEventId).negatingTransitions.emplace_back(parent, transition);
+    }
+    return state;
+}
+
+SequenceDetector::EventTransitions& SequenceDetector::GetEventTransitions(EventID eventId) {
+    if (auto eventPair = eventTransitions.find(eventId); eventPair != eventTransitions.end()) {
+        return eventPair->second;
+    }
+
+    auto& transitions = eventTransitions[Event(eventId)];
+    transitions.eventHandlerId = blackboard.AddEventHandler<&SequenceDetector::OnEvent>(
+            eventId, this, Blackboard::CallEventHandlerOnce::No);
+    return transitions;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool SequenceDetector::OnEvent(EventID eventId, const Object& eventContent) {
+    const auto now = std::chrono::steady_clock::now();
+    Advance(now);
+
+    const auto eventPair = eventTransitions.find(eventId);
+    if (eventPair == eventTransitions.end()) {
+        return true;
+    }
+    const auto& transitions = eventPair->second;
+
+    // Copied once, and only if the event takes any transition.
+    std::shared_ptr<const Object> sharedEventContent;
+    const auto shareEventContent = [&sharedEventContent, &eventContent] {
+        if (!sharedEventContent) {
+            sharedEventContent = std::make_shared<const Object>(eventContent);
+        }
+        return sharedEventContent;
+    };
+
+    // Negations apply first, so that an event that both blocks and takes transitions of the same
+    // partial matches blocks them.
+    std::vector<std::size_t> bucket;
+    for (const auto& [state, transition] : transitions.negatingTransitions) {
+        const auto key = GetKey(state, eventContent);
+        if (!key) {
+            continue;
+        }
+        const auto bucketPair = states[state].partialMatchesByKey.find(*key);
+        if (bucketPair == states[state].partialMatchesByKey.end()) {
+            continue;
+        }
+        // Copied, since partial matches may be removed while iterating.
+        bucket = bucketPair->second;
+        for (const auto partialMatch : bucket) {
+            CloseTransition(partialMatch, transition);
+        }
+    }
+
+    // Partial matches entering new states are added only after all transitions have been taken,
+    // so that none of them takes more than one transition per event.
+    std::vector<Match> enteringMatches;
+    for (const auto& [state, transition] : transitions.advancingTransitions) {
+        const auto key = GetKey(state, eventContent);
+        if (!key) {
+            continue;
+        }
+        const auto bucketPair = states[state].partialMatchesByKey.find(*key);
+        if (bucketPair == states[state].partialMatchesByKey.end()) {
+            continue;
+        }
+        bucket = bucketPair->second;
+        for (const auto partialMatch : bucket) {
+            const auto& advancingMatch = partialMatches[partialMatch];
+            if (advancingMatch.closedTransitions & (std::uint64_t(1) << transition)) {
+                continue;
+            }
+            enteringMatches.push_back({states[state].transitions[transition], *key,
+                                       advancingMatch.start,
+                                       std::make_shared<const MatchedStep>(MatchedStep{
+                                               shareEventContent(),
+                                               advancingMatch.matchedSteps})});
+            CloseTransition(partialMatch, transition);
+        }
+    }
+
+    for (const auto state : transitions.startingStates) {
+        if (const auto key = GetKey(state, eventContent)) {
+            enteringMatches.push_back({state, *key, now,
+                                       std::make_shared<const MatchedStep>(
+                                               MatchedStep{shareEventContent(), nullptr})});
+        }
+    }
+
+    std::vector<Match> matches;
+    for (auto& enteringMatch : enteringMatches) {
+        Enter(std::move(enteringMatch), &matches);
+    }
+
+    // Posted last, since handlers of match events may post events of the patterns.
+    for (const auto& match : matches) {
+        PostMatch(match);
+    }
+    return true;
+}
+
+std::optional<Value> SequenceDetector::GetKey(std::size_t state,
+                                              const Object& eventContent) const {
+    const auto& keyField = roots[states[state].root].keyField;
+    if (!keyField) {
+        return Value();
+    }
+    return eventContent.GetValue(*keyField);
+}
+
+void SequenceDetector::CloseTransition(std::size_t partialMatch, std::size_t transition) {
+    auto& closedTransitions = partialMatches[partialMatch].closedTransitions;
+    closedTransitions |= std::uint64_t(1) << transition;
+
+    const auto& state = states[partialMatches[partialMatch].state];
+    if (std::bitset<maxTransitions>(closedTransitions).count() == state.transitions.size()) {
+        RemovePartialMatch(partialMatch);
+    }
+}
+
+void SequenceDetector::Enter(Match&& match, std::vector<Match>* matches) {
+    auto& state = states[match.state];
+    if (state.transitions.empty()) {
+        matches->push_back(std::move(match));
+        return;
+    }
+    if (!state.matchEventIds.empty()) {
+        matches->push_back(match);
+    }
+
+    if (state.partialMatchCount == maxPartialMatchesPerState) {
+        RemovePartialMatch(state.oldestPartialMatch);
+        ++evictedPartialMatches;
+    }
+
+    std::size_t partialMatch;
+    if (!freePartialMatches.empty()) {
+        partialMatch = freePartialMatches.back();
+        freePartialMatches.pop_back();
+    } else {
+        partialMatch = partialMatches.size();
+        partialMatches.push_back({noState, Value(), Deadline(), nullptr, 0, 0, noPartialMatch,
+                                  noPartialMatch, 0});
+    }
+
+    auto& bucket = state.partialMatchesByKey[match.key];
+    auto& newPartialMatch = partialMatches[partialMatch];
+    newPartialMatch.state = match.state;
+    newPartialMatch.key = std::move(match.key);
+    newPartialMatch.start = match.start;
+    newPartialMatch.matchedSteps = std::move(match.matchedSteps);
+    newPartialMatch.closedTransitions = 0;
+    newPartialMatch.position = bucket.size();
+    bucket.push_back(partialMatch);
+
+    newPartialMatch.older = state.newestPartialMatch;
+    newPartialMatch.newer = noPartialMatch;
+    if (state.newestPartialMatch != noPartialMatch) {
+        partialMatches[state.newestPartialMatch].newer = partialMatch;
+    } else {
+        state.oldestPartialMatch = partialMatch;
+    }
+    state.newestPartialMatch = partialMatch;
+    ++state.partialMatchCount;
+    ++partialMatchCount;
+
+    const auto window = roots[state.root].window;
+    if (window != Duration::max()) {
+        expiries.push({match.start + window, partialMatch, newPartialMatch.generation});
+    }
+}
+
+void SequenceDetector::RemovePartialMatch(std::size_t partialMatch) {
+    auto& removedPartialMatch = partialMatches[partialMatch];
+    auto& state = states[removedPartialMatch.state];
+    auto& partialMatchesByKey = state.partialMatchesByKey;
+    const auto bucketPair = partialMatchesByKey.find(removedPartialMatch.key);
+    assert(bucketPair != partialMatchesByKey.end());
+
+    // Keys are erased along with their last partial match, so that they do not accumulate.
+    auto& bucket = bucketPair->second;
+    const auto movedPartialMatch = bucket.back();
+    bucket[removedPartialMatch.position] = movedPartialMatch;
+    partialMatches[movedPartialMatch].position = removedPartialMatch.position;
+    bucket.pop_back();
+    if (bucket.empty()) {
+        partialMatchesByKey.erase(bucketPair);
+    }
+
+    if (removedPartialMatch.older != noPartialMatch) {
+        partialMatches[removedPartialMatch.older].newer = removedPartialMatch.newer;
+    } else {
+        state.oldestPartialMatch = removedPartialMatch.newer;
+    }
+    if (removedPartialMatch.newer != noPartialMatch) {
+        partialMatches[removedPartialMatch.newer].older = removedPartialMatch.older;
+    } else {
+        state.newestPartialMatch = removedPartialMatch.older;
+    }
+    --state.partialMatchCount;
+
+    ++removedPartialMatch.generation;
+    removedPartialMatch.key = Value();
+    removedPartialMatch.matchedSteps = nullptr;
+    freePartialMatches.push_back(partialMatch);
+    --partialMatchCount;
+}
+
+void SequenceDetector::PostMatch(const Match& match) {
+    const auto& state = states[match.state];
+
+    // Steps are chained newest first.
+    Object matchedEvents;
+    auto step = state.depth;
+    for (auto matchedStep = match.matchedSteps.get(); matchedStep;
+            matchedStep = matchedStep->previous.get()) {
+        matchedEvents.AddValue(Value{static_cast<double>(--step)},
+                               Value{*matchedStep->eventContent});
+    }
+
+    Object eventContent;
+    eventContent.AddValue(Value{std::string_view("Events")}, Value{matchedEvents});
+    if (roots[state.root].keyField) {
+        eventContent.AddValue(Value{std::string_view("Key")}, match.key);
+    }
+    for (const auto& matchEventId : state.matchEventIds) {
+        blackboard.PostEvent(matchEventId, eventContent);
+    }
+}
+
+} // namespace blackboard
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+
+namespace blackboard {
+
+// Shared with the helper tasks of ParallelFor(), which may start only after every index has been
+// claimed and ParallelFor() has returned.
+struct ThreadPool::ParallelForState {
+    ParallelForState(std::size_t count, const IndexedTask& task)
+        : task(&task), count(count), nextIndex(0), completed(0) {}
+
+    const IndexedTask* task;
+    const std::size_t count;
+    std::atomic<std::size_t> nextIndex;
+
+    std::size_t completed;
+    std::mutex completedMutex;
+    std::condition_variable completedCondition;
+};
+
+void ThreadPool::RunParallelForIndices(ParallelForState& state) {
+    std::size_t completedHere = 0;
+    for (auto index = state.nextIndex.fetch_add(1); index < state.count;
+            index = state.nextIndex.fetch_add(1)) {
+        (*state.task)(index);
+        ++completedHere;
+    }
+
+    if (completedHere != 0) {
+        const std::lock_guard<std::mutex> lock(state.completedMutex);
+        state.completed += completedHere;
+        if (state.completed == state.count) {
+            state.completedCondition.notify_all();
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Identify the pool and the worker the current thread belongs to, if any, so that tasks executed by
+// a worker are queued to the worker itself.
+static thread_local const ThreadPool* currentThreadPool = nullptr;
+static thread_local std::size_t currentWorkerIndex = 0;
+
+//--------------------------------------------------------------------------------------------------
+
+ThreadPool::ThreadPool(std::size_t threadCount) : nextWorkerIndex(0), queuedTasks(0),
+                                                  stopping(false) {
+    assert(threadCount > 0);
+    workers.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+
+    threads.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back([this, i] { RunWorker(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        const std::lock_guard<std::mutex> lock(idleMutex);
+        stopping = true;
+    }
+    idleCondition.notify_all();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool ThreadPool::TryToPopTask(std::size_t workerIndex, Task* task) {
+    auto& worker = *workers[workerIndex];
+    const std::lock_guard<std::mutex> lock(worker.tasksMutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    *task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    queuedTasks.fetch_sub(1);
+    return true;
+}
+
+bool ThreadPool::TryToStealTask(std::size_t workerIndex, Task* task) {
+    for (std::size_t i = 1; i < workers.size(); ++i) {
+        auto& victim = *workers[(workerIndex + i) % workers.size()];
+        const std::lock_guard<std::mutex> lock(victim.tasksMutex);
+        if (!victim.tasks.empty()) {
+            *task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queuedTasks.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::RunWorker(std::size_t workerIndex) {
+    currentThreadPool = this;
+    currentWorkerIndex = workerIndex;
+
+    while (true) {
+        Task task;
+        if (TryToPopTask(workerIndex, &task) || TryToStealTask(workerIndex, &task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idleMutex);
+        idleCondition.wait(lock, [this] { return stopping || queuedTasks.load() != 0; });
+        if (stopping && queuedTasks.load() == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::Execute(Task&& task) {
+    const auto workerIndex = currentThreadPool == this
+                             ? currentWorkerIndex
+                             : nextWorkerIndex.fetch_add(1) % workers.size();
+
+    // Counted before being published, so that workers taking the task never decrement the count
+    // below zero.
+    {
+        const std::lock_guard<std::mutex> lock(idleMutex);
+        assert(!stopping);
+        queuedTasks.fetch_add(1);
+    }
+    auto& worker = *workers[workerIndex];
+    {
+        const std::lock_guard<std::mutex> lock(worker.tasksMutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    idleCondition.notify_one();
+}
+
+void ThreadPool::ParallelFor(std::size_t count, const IndexedTask& task) {
+    if (count <= 1) {
+        if (count == 1) {
+            task(0);
+        }
+        return;
+    }
+
+    const auto state = std::make_shared<ParallelForState>(count, task);
+
+    const auto helperCount = std::min(count - 1, threads.size());
+    for (std::size_t i = 0; i < helperCount; ++i) {
+        Execute([state] { RunParallelForIndices(*state); });
+    }
+    RunParallelForIndices(*state);
+
+    std::unique_lock<std::mutex> lock(state->completedMutex);
+    state->completedCondition.wait(lock, [&state, count] { return state->completed == count; });
+}
+
+std::size_t ThreadPool::GetThreadCount() const {
+    return threads.size();
+}
+
+std::size_t ThreadPool::GetDefaultThreadCount() {
+    const std::size_t hardwareThreadCount = std::thread::hardware_concurrency();
+    return hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 1;
+}
+
+} // namespace blackboard
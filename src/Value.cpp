@@ -5,73 +5,17 @@
 
 #include <limits>
 #include <cassert>
+#include <utility>
 
 namespace blackboard {
 
-template <typename T>
-constexpr bool Value::HasType() const noexcept {
-    return std::holds_alternative<T>(value);
-}
-
-template <typename T>
-constexpr T Value::Get() const noexcept {
-    return std::get<T>(value);
-}
-
-constexpr bool Value::IsUndefined() const noexcept {
-    return HasType<Value::UndefinedType>();
-}
-
-constexpr bool Value::IsNumber() const noexcept {
-    return HasType<Value::NumberType>();
-}
-
-constexpr bool Value::IsString() const noexcept {
-    return HasType<Value::StringType>();
-}
-
-constexpr bool Value::IsBoolean() const noexcept {
-    return HasType<Value::BooleanType>();
-}
-
-constexpr bool Value::IsReference() const noexcept {
-    return HasType<Value::ReferenceType>();
-}
-
-constexpr bool Value::IsObject() const noexcept {
-    return HasType<Value::ObjectType>();
-}
-
-constexpr Value::NumberType Value::GetNumber() const noexcept {
-    return Get<Value::NumberType>();
-}
-
-constexpr Value::StringType Value::GetString() const noexcept {
-    return Get<Value::StringType>();
-}
-
-constexpr Value::BooleanType Value::GetBoolean() const noexcept {
-    return Get<Value::BooleanType>();
-}
-
-constexpr Value::ReferenceType Value::GetReference() const noexcept {
-    return Get<Value::ReferenceType>();
-}
-
-constexpr Value::ObjectType Value::GetObject() const noexcept {
-    return Get<Value::ObjectType>();
-}
-
-//--------------------------------------------------------------------------------------------------
-
 Value::Value() : value(UndefinedType()) {}
 
 Value::Value(const Value& from) {
     InitializeFrom(from);
 }
 
-Value::Value(Value&& from) noexcept {
-    InitializeFrom(from);
+Value::Value(Value&& from) noexcept : value(from.value) {
     from.value = UndefinedType();
 }
 
@@ -112,8 +56,11 @@ Value& Value::operator=(const Value& from) noexcept {
 }
 
 Value& Value::operator=(Value&& from) noexcept {
-    this->~Value();
-    return *new (this) Value(from);
+    if (this != &from) {
+        this->~Value();
+        new (this) Value(std::move(from));
+    }
+    return *this;
 }
 
 bool Value::operator==(const Value& other) const noexcept {
@@ -280,4 +227,15 @@ std::size_t ValueHash::operator()(const Value& value) const {
     }
 }
 
+bool ValueLess::operator()(const Value& lhs, const Value& rhs) const {
+    assert((lhs.IsNumber() || lhs.IsString()) && (rhs.IsNumber() || rhs.IsString()));
+    if (lhs.IsNumber() != rhs.IsNumber()) {
+        return lhs.IsNumber();
+    } else if (lhs.IsNumber()) {
+        return lhs.GetNumber() < rhs.GetNumber();
+    } else {
+        return *lhs.GetString() < *rhs.GetString();
+    }
+}
+
 } // namespace blackboard
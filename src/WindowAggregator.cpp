@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/WindowAggregator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <string_view>
+
+namespace blackboard {
+
+static std::string MakePercentileKey(double percentile) {
+    auto key = std::to_string(percentile);
+    key.erase(key.find_last_not_of('0') + 1);
+    if (key.back() == '.') {
+        key.pop_back();
+    }
+    return "P" + key;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+WindowAggregator::WindowAggregator(Blackboard& blackboard, EventID eventId, const Value& field,
+                                   EventID resultEventId, Duration windowLength,
+                                   const std::vector<double>& percentiles)
+    : WindowAggregator(blackboard, eventId, field, resultEventId, windowLength, windowLength,
+                       percentiles) {}
+
+WindowAggregator::WindowAggregator(Blackboard& blackboard, EventID eventId, const Value& field,
+                                   EventID resultEventId, Duration windowLength, Duration slide,
+                                   const std::vector<double>& percentiles)
+    : blackboard(blackboard), eventId(eventId), field(field), resultEventId(resultEventId),
+      slide(slide), numPanes(static_cast<std::size_t>(windowLength / slide)),
+      paneEnd(std::chrono::steady_clock::now() + slide), eventHandlerId(0), currentPane(),
+      frontPanes(), backPanes(), backPanesAggregate(), percentiles(percentiles), samples(),
+      firstSample(0), paneSampleCounts(numPanes), windowSamples(), result(), resultKeys() {
+    assert(slide > Duration::zero() && windowLength % slide == Duration::zero());
+
+    frontPanes.reserve(numPanes);
+    backPanes.reserve(numPanes);
+
+    for (const std::string_view key : {"Count", "Sum", "Min", "Max", "Mean"}) {
+        resultKeys.emplace_back(key);
+    }
+    for (const auto percentile : percentiles) {
+        assert(percentile > 0.0 && percentile <= 100.0);
+        resultKeys.emplace_back(MakePercentileKey(percentile));
+    }
+
+    eventHandlerId = blackboard.AddEventHandler<&WindowAggregator::OnEvent>(
+            eventId, this, Blackboard::CallEventHandlerOnce::No);
+}
+
+WindowAggregator::~WindowAggregator() {
+    blackboard.RemoveEventHandler(eventId, eventHandlerId);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void WindowAggregator::Advance(Deadline now) {
+    while (now >= paneEnd) {
+        ClosePane();
+        paneEnd += slide;
+
+        // Once only empty panes are left, skip straight to the pane that contains `now`.
+        const auto& oldestPanes = frontPanes.empty() ? Aggregate() : frontPanes.back();
+        if (Aggregate::Combine(oldestPanes, backPanesAggregate).count == 0 && now >= paneEnd) {
+            frontPanes.clear();
+            backPanes.clear();
+            backPanesAggregate = Aggregate();
+            paneSampleCounts.Clear();
+            samples.clear();
+            firstSample = 0;
+            paneEnd += (now - paneEnd) / slide * slide + slide;
+        }
+    }
+}
+
+bool WindowAggregator::OnEvent(EventID, const Object& eventContent) {
+    Advance(std::chrono::steady_clock::now());
+
+    const auto value = eventContent.GetValue(field);
+    if (!value || !value->IsNumber()) {
+        return true;
+    }
+
+    const auto sample = value->ToNumber();
+    currentPane.Add(sample);
+    if (!percentiles.empty()) {
+        samples.push_back(sample);
+    }
+    return true;
+}
+
+void WindowAggregator::ClosePane() {
+    if (frontPanes.size() + backPanes.size() == numPanes) {
+        EvictPane();
+    }
+
+    backPanes.push_back(currentPane);
+    backPanesAggregate = Aggregate::Combine(backPanesAggregate, currentPane);
+    if (!percentiles.empty()) {
+        paneSampleCounts.Push() = currentPane.count;
+    }
+    currentPane = Aggregate();
+
+    const auto& oldestPanes = frontPanes.empty() ? Aggregate() : frontPanes.back();
+    PostResult(Aggregate::Combine(oldestPanes, backPanesAggregate));
+}
+
+void WindowAggregator::EvictPane() {
+    // Moves the panes of the back stack to the front one, each with the aggregate of itself and all
+    // the newer panes, so that the oldest pane ends up on top.
+    if (frontPanes.empty()) {
+        Aggregate newerPanes;
+        for (auto pane = backPanes.rbegin(); pane != backPanes.rend(); ++pane) {
+            newerPanes = Aggregate::Combine(*pane, newerPanes);
+            frontPanes.push_back(newerPanes);
+        }
+        backPanes.clear();
+        backPanesAggregate = Aggregate();
+    }
+    frontPanes.pop_back();
+
+    if (!percentiles.empty()) {
+        firstSample += paneSampleCounts.Front();
+        paneSampleCounts.Pop();
+        if (firstSample >= samples.size() / 2) {
+            samples.erase(samples.begin(), samples.begin() + firstSample);
+            firstSample = 0;
+        }
+    }
+}
+
+void WindowAggregator::PostResult(const Aggregate& window) {
+    if (window.count == 0) {
+        return;
+    }
+
+    result.AddValue(resultKeys[0], Value{static_cast<double>(window.count)});
+    result.AddValue(resultKeys[1], Value{window.sum});
+    result.AddValue(resultKeys[2], Value{window.min});
+    result.AddValue(resultKeys[3], Value{window.max});
+    result.AddValue(resultKeys[4], Value{window.sum / static_cast<double>(window.count)});
+
+    if (!percentiles.empty()) {
+        // Nearest-rank percentiles, selected from a copy of the samples of the window.
+        windowSamples.assign(samples.begin() + firstSample, samples.end());
+        for (std::size_t i = 0; i < percentiles.size(); ++i) {
+            const auto rank = static_cast<std::size_t>(
+                    std::ceil(percentiles[i] / 100.0 * static_cast<double>(windowSamples.size())));
+            const auto nth = windowSamples.begin() + (std::max<std::size_t>(rank, 1) - 1);
+            std::nth_element(windowSamples.begin(), nth, windowSamples.end());
+            result.AddValue(resultKeys[5 + i], Value{*nth});
+        }
+    }
+
+    blackboard.PostEvent(resultEventId, result);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void WindowAggregator::Aggregate::Add(double sample) {
+    min = count == 0 ? sample : std::min(min, sample);
+    max = count == 0 ? sample : std::max(max, sample);
+    sum += sample;
+    ++count;
+}
+
+WindowAggregator::Aggregate WindowAggregator::Aggregate::Combine(const Aggregate& first,
+                                                                 const Aggregate& second) {
+    if (first.count == 0) {
+        return second;
+    }
+    if (second.count == 0) {
+        return first;
+    }
+    return {first.count + second.count, first.sum + second.sum, std::min(first.min, second.min),
+            std::max(first.max, second.max)};
+}
+
+} // namespace blackboard
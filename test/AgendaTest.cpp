@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/Agenda.h"
+
+#include <vector>
+
+#include <catch.hpp>
+
+using namespace blackboard;
+
+using EntryId = Agenda::EntryId;
+
+static std::vector<EntryId> PopAll(Agenda& agenda) {
+    std::vector<EntryId> entryIds;
+    while (!agenda.IsEmpty()) {
+        entryIds.push_back(agenda.Pop());
+    }
+    return entryIds;
+}
+
+TEST_CASE("AgendaOrder", "[AgendaTest]") {
+    Agenda agenda;
+    agenda.Push(0, 1.0);
+    agenda.Push(1, 5.0);
+    agenda.Push(2, 1.0);
+    agenda.Push(3, 3.0);
+    agenda.Push(4, 1.0);
+
+    REQUIRE(agenda.GetSize() == 5);
+    REQUIRE(agenda.GetTop() == 1);
+
+    // Make sure entries with equal scores are popped in the order they were pushed.
+    REQUIRE(PopAll(agenda) == std::vector<EntryId>{1, 3, 0, 2, 4});
+    REQUIRE(!agenda.Contains(1));
+}
+
+TEST_CASE("AgendaUpdateAndRemove", "[AgendaTest]") {
+    Agenda agenda;
+    for (EntryId entryId = 0; entryId < 8; ++entryId) {
+        agenda.Push(entryId, static_cast<double>(entryId));
+    }
+
+    agenda.Update(0, 10.0);
+    agenda.Update(7, -1.0);
+    agenda.Remove(5);
+    agenda.Remove(3);
+    REQUIRE(agenda.GetScore(0) == 10.0);
+    REQUIRE(!agenda.Contains(5));
+
+    // Make sure removed entries can be pushed again.
+    agenda.Push(5, 4.5);
+    REQUIRE(PopAll(agenda) == std::vector<EntryId>{0, 6, 5, 4, 2, 1, 7});
+}
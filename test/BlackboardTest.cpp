@@ -5,7 +5,12 @@
 #include "Blackboard/Object.h"
 #include "Blackboard/Value.h"
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <limits>
+#include <thread>
+#include <vector>
 
 #include <catch.hpp>
 
@@ -19,6 +24,8 @@ using CallEventHandlerOnce = Blackboard::CallEventHandlerOnce;
 using BlackboardException = Blackboard::BlackboardException;
 using BlackboardQueuedException = Blackboard::BlackboardQueuedException;
 using UnhandledEventException = Blackboard::UnhandledEventException;
+using InvocationResult = Blackboard::InvocationResult;
+using DispatchResult = Blackboard::DispatchResult;
 
 //--------------------------------------------------------------------------------------------------
 
@@ -831,3 +838,872 @@ TEST_CASE("PostQueuedException", "[BlackboardTest]") {
     }
     REQUIRE(blackboardQueuedExceptionThrown);
 }
+
+TEST_CASE("CheckedEventHandler", "[BlackboardTest]") {
+    std::size_t eventHandlersCalled = 0;
+
+    Blackboard blackboard;
+
+    // Register handlers that continue, stop and fail the invocation loop respectively.
+    blackboard.AddEventHandler(eventMouseClickLeft, [&eventHandlersCalled](EventID, const Object&) {
+        eventHandlersCalled++;
+        return InvocationResult::Continue;
+    }, CallEventHandlerOnce::No);
+    blackboard.AddEventHandler(eventMouseClickLeft, [&eventHandlersCalled](EventID, const Object&) {
+        eventHandlersCalled++;
+        return InvocationResult::Stop;
+    }, CallEventHandlerOnce::Yes);
+    blackboard.AddEventHandler(eventMouseClickLeft, [&eventHandlersCalled](EventID, const Object&) {
+        eventHandlersCalled++;
+        return InvocationResult::Error;
+    }, CallEventHandlerOnce::No);
+    blackboard.AddEventHandler(eventMouseClickLeft, [&eventHandlersCalled](EventID, const Object&) {
+        eventHandlersCalled++;
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    // Create dummy event content.
+    Object dummyObject{};
+
+    // Make sure the invocation loop has been stopped by the second handler.
+    REQUIRE(blackboard.TryPostEvent(eventMouseClickLeft, dummyObject) == DispatchResult::Success);
+    REQUIRE(eventHandlersCalled == 2);
+
+    // Make sure the failure of the third handler has been reported, once the second is removed.
+    REQUIRE(blackboard.TryPostEvent(eventMouseClickLeft, dummyObject) ==
+            DispatchResult::HandlerError);
+    REQUIRE(eventHandlersCalled == 4);
+}
+
+TEST_CASE("TryPostEventRequiringHandler", "[BlackboardTest]") {
+    Blackboard blackboard;
+
+    // Register error handler.
+    std::size_t errorsReported = 0;
+    blackboard.SetErrorHandler([&errorsReported](EventID eventId, const Object&,
+                                                 DispatchResult dispatchResult) {
+        REQUIRE(eventId == eventMouseClickLeft);
+        REQUIRE(dispatchResult == DispatchResult::UnhandledEvent);
+        errorsReported++;
+    });
+
+    // Create dummy event content.
+    Object dummyObject{};
+
+    // Post unhandled events and make sure only the one requiring a handler has failed.
+    REQUIRE(blackboard.TryPostEvent(eventMouseClickLeft, dummyObject) == DispatchResult::Success);
+    REQUIRE(blackboard.TryPostEventRequiringHandler(eventMouseClickLeft, dummyObject) ==
+            DispatchResult::UnhandledEvent);
+    REQUIRE(errorsReported == 1);
+}
+
+TEST_CASE("TryProcessQueuedEvents", "[BlackboardTest]") {
+    Blackboard blackboard;
+
+    // Register event handler.
+    std::size_t eventHandlersCalled = 0;
+    blackboard.AddEventHandler(eventMouseClickRight, [&eventHandlersCalled](EventID, const Object&) {
+        eventHandlersCalled++;
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    // Register error handler.
+    std::size_t errorsReported = 0;
+    blackboard.SetErrorHandler([&errorsReported](EventID, const Object&, DispatchResult) {
+        errorsReported++;
+    });
+
+    // Create dummy event content.
+    Object dummyObject{};
+
+    // Post queued events, interleaving failing ones with handled ones.
+    blackboard.PostQueuedEvent(eventMouseClickRight, dummyObject);
+    blackboard.PostQueuedEventRequiringHandler(eventMouseClickLeft, dummyObject);
+    blackboard.PostQueuedEvent(eventMouseClickRight, dummyObject);
+    blackboard.PostQueuedException(eventMouseClickMiddle, dummyObject);
+    blackboard.PostQueuedEvent(eventMouseClickRight, dummyObject);
+
+    // Process queued events and make sure failures have not stopped processing.
+    auto queuedEventsReport = blackboard.TryProcessQueuedEvents();
+    REQUIRE(queuedEventsReport.processedEvents == 5);
+    REQUIRE(queuedEventsReport.failedEvents == 2);
+    REQUIRE(queuedEventsReport.firstFailure == DispatchResult::UnhandledEvent);
+    REQUIRE(queuedEventsReport.firstFailedEvent == eventMouseClickLeft);
+    REQUIRE(queuedEventsReport.firstFailedEventContent == &dummyObject);
+    REQUIRE(eventHandlersCalled == 3);
+    REQUIRE(errorsReported == 2);
+
+    // Make sure the queue has been drained.
+    queuedEventsReport = blackboard.TryProcessQueuedEvents();
+    REQUIRE(queuedEventsReport.processedEvents == 0);
+}
+
+TEST_CASE("DeadLetters", "[BlackboardTest]") {
+    Blackboard blackboard;
+
+    // Register event handler.
+    blackboard.AddEventHandler(eventMouseClickRight, MouseClickRightHandler,
+                               CallEventHandlerOnce::No);
+
+    // Construct event content.
+    Value numberValue{13.0};
+    Object dummyObject{};
+    dummyObject.AddValue(numberValue, numberValue);
+
+    // Make sure nothing is captured before dead letters are enabled.
+    blackboard.PostEvent(eventMouseClickLeft, dummyObject);
+    REQUIRE(blackboard.PeekDeadLetters().empty());
+
+    // Post unhandled events, both directly and through the queue.
+    blackboard.EnableDeadLetters(2);
+    blackboard.PostEvent(eventMouseClickLeft, dummyObject);
+    blackboard.PostEvent(eventMouseClickRight, dummyObject);
+    blackboard.PostQueuedEvent(eventMouseClickMiddle, dummyObject);
+    REQUIRE(blackboard.TryPostEventRequiringHandler(eventMouseClickMiddle, dummyObject) ==
+            DispatchResult::UnhandledEvent);
+    blackboard.ProcessQueuedEvents();
+    MouseClickRightHandlerCalled = false;
+
+    // Make sure only the two newest dead letters have been kept.
+    REQUIRE(blackboard.GetOverwrittenDeadLetterCount() == 1);
+    REQUIRE(blackboard.PeekDeadLetters().size() == 2);
+
+    auto deadLetters = blackboard.DrainDeadLetters();
+    REQUIRE(deadLetters.size() == 2);
+    REQUIRE(deadLetters[0].event == eventMouseClickMiddle);
+    REQUIRE(deadLetters[1].event == eventMouseClickMiddle);
+    REQUIRE(deadLetters[1].eventContent == dummyObject);
+    REQUIRE(deadLetters[1].threadIdPostedBy == std::this_thread::get_id());
+    REQUIRE(deadLetters[0].timestamp <= deadLetters[1].timestamp);
+    REQUIRE(blackboard.DrainDeadLetters().empty());
+}
+
+TEST_CASE("RetainedEvents", "[BlackboardTest]") {
+    Blackboard blackboard;
+
+    auto makeEventContent = [](double number) {
+        Object eventContent{};
+        eventContent.AddValue(Value{"Number"s}, Value{number});
+        return eventContent;
+    };
+
+    // Make sure payloads are retained without any handler, keeping only the newest ones.
+    blackboard.RetainEvents("State", 2);
+    for (auto number = 1.0; number <= 3.0; ++number) {
+        blackboard.PostEvent("State", makeEventContent(number));
+    }
+    REQUIRE(blackboard.PeekRetainedEvents("State") ==
+            std::vector<Object>{makeEventContent(2.0), makeEventContent(3.0)});
+
+    // Make sure the retained payloads are replayed in order to a new handler, before new ones.
+    std::vector<double> numbers;
+    blackboard.AddEventHandler("State", [&numbers](EventID, const Object& eventContent) {
+        numbers.push_back(eventContent.GetValue(Value{"Number"s})->ToNumber());
+        return true;
+    }, CallEventHandlerOnce::No);
+    const auto queuedEventContent = makeEventContent(4.0);
+    blackboard.PostQueuedEvent("State", queuedEventContent);
+    blackboard.ProcessQueuedEvents();
+    REQUIRE(numbers == std::vector<double>{2.0, 3.0, 4.0});
+
+    // Make sure one-time handlers receive only the newest payload, and are removed afterwards.
+    std::size_t oneTimeHandlerCalls = 0;
+    blackboard.AddEventHandler("State", [&oneTimeHandlerCalls](EventID,
+                                                               const Object& eventContent) {
+        REQUIRE(eventContent.GetValue(Value{"Number"s})->ToNumber() == 4.0);
+        ++oneTimeHandlerCalls;
+        return true;
+    }, CallEventHandlerOnce::Yes);
+    blackboard.PostEvent("State", makeEventContent(5.0));
+    REQUIRE(oneTimeHandlerCalls == 1);
+
+    // Make sure batch handlers receive all of the retained payloads in a single batch.
+    std::vector<std::size_t> batchSizes;
+    blackboard.AddBatchEventHandler("State", [&batchSizes](EventID,
+                                                           Blackboard::EventContentSpan batch) {
+        batchSizes.push_back(batch.GetSize());
+        return true;
+    }, CallEventHandlerOnce::No);
+    REQUIRE(batchSizes == std::vector<std::size_t>{2});
+
+    // Make sure shrinking keeps the newest payloads, and disabling stops replaying them.
+    blackboard.RetainEvents("State", 1);
+    REQUIRE(blackboard.PeekRetainedEvents("State") == std::vector<Object>{makeEventContent(5.0)});
+    blackboard.RetainEvents("State", 0);
+    REQUIRE(blackboard.PeekRetainedEvents("State").empty());
+
+    numbers.clear();
+    blackboard.AddEventHandler("State", [&numbers](EventID, const Object&) {
+        numbers.push_back(0.0);
+        return true;
+    }, CallEventHandlerOnce::No);
+    REQUIRE(numbers.empty());
+}
+
+TEST_CASE("FieldChangeHandlers", "[BlackboardTest]") {
+    Blackboard blackboard;
+
+    Object eventContent{};
+    eventContent.AddValue(Value{"Temperature"s}, Value{20.0});
+    eventContent.AddValue(Value{"Humidity"s}, Value{40.0});
+
+    std::vector<ObjectDelta> deltas;
+    blackboard.AddFieldChangeHandler("State", {{Value{"Temperature"s}}},
+                                     [&deltas](EventID, const Object&, const ObjectDelta& delta) {
+        deltas.push_back(delta);
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    std::size_t oneTimeHandlerCalls = 0;
+    blackboard.AddFieldChangeHandler("State", {{Value{"Humidity"s}}},
+                                     [&oneTimeHandlerCalls](EventID, const Object&,
+                                                            const ObjectDelta&) {
+        ++oneTimeHandlerCalls;
+        return true;
+    }, CallEventHandlerOnce::Yes);
+
+    // Make sure the first event is a change, while the same fields posted again are not.
+    blackboard.PostEvent("State", eventContent);
+    blackboard.PostEvent("State", eventContent);
+    REQUIRE(deltas.size() == 1);
+    REQUIRE(deltas[0].size() == 1);
+    REQUIRE(deltas[0][0].value == Value{20.0});
+
+    // Make sure changes of other fields are ignored.
+    eventContent.AddValue(Value{"Humidity"s}, Value{45.0});
+    blackboard.PostEvent("State", eventContent);
+    REQUIRE(deltas.size() == 1);
+    REQUIRE(oneTimeHandlerCalls == 1);
+
+    eventContent.AddValue(Value{"Temperature"s}, Value{21.0});
+    blackboard.PostEvent("State", eventContent);
+    eventContent.RemoveValue(Value{"Temperature"s});
+    blackboard.PostEvent("State", eventContent);
+    REQUIRE(deltas.size() == 3);
+    REQUIRE(deltas[1][0].value == Value{21.0});
+    REQUIRE(!deltas[2][0].value);
+}
+
+TEST_CASE("PostEventWithContentFactory", "[BlackboardTest]") {
+    Blackboard blackboard;
+
+    // Create a factory that counts how many payloads it has built.
+    std::size_t eventContentsBuilt = 0;
+    auto eventContentFactory = [&eventContentsBuilt] {
+        eventContentsBuilt++;
+        Object eventContent{};
+        eventContent.AddValue(Value{"Thirteen"s}, Value{13.0});
+        return eventContent;
+    };
+
+    // Make sure no payload is built while there are no handlers.
+    REQUIRE(!blackboard.HasHandlers(eventMouseClickLeft));
+    blackboard.PostEvent(eventMouseClickLeft, eventContentFactory);
+    REQUIRE(blackboard.TryPostEvent(eventMouseClickLeft, eventContentFactory) ==
+            DispatchResult::Success);
+    REQUIRE(eventContentsBuilt == 0);
+
+    // Register a one-time handler and make sure the payload is built for it.
+    blackboard.AddEventHandler(eventMouseClickLeft, MouseClickLeftHandler, CallEventHandlerOnce::Yes);
+    REQUIRE(blackboard.HasHandlers(eventMouseClickLeft));
+    REQUIRE(!blackboard.HasHandlers(eventMouseClickRight));
+    blackboard.PostEvent(eventMouseClickLeft, eventContentFactory);
+    REQUIRE(eventContentsBuilt == 1);
+    REQUIRE(MouseClickLeftHandlerCalled);
+    MouseClickLeftHandlerCalled = false;
+    MouseClickLeftEventContent = nullptr;
+
+    // Make sure the handler is gone, along with the need to build payloads.
+    REQUIRE(!blackboard.HasHandlers(eventMouseClickLeft));
+    blackboard.PostEvent(eventMouseClickLeft, eventContentFactory);
+    REQUIRE(eventContentsBuilt == 1);
+
+    // Make sure payloads are still built for dead letters.
+    blackboard.EnableDeadLetters(1);
+    blackboard.PostEvent(eventMouseClickLeft, eventContentFactory);
+    REQUIRE(eventContentsBuilt == 2);
+    REQUIRE(blackboard.DrainDeadLetters().size() == 1);
+}
+
+TEST_CASE("EventHandlerPriorities", "[BlackboardTest]") {
+    std::vector<int> invocationOrder;
+
+    Blackboard blackboard;
+
+    // Register handlers out of order, including two of equal priority.
+    for (const auto priority : {0, 10, -5, 10}) {
+        blackboard.AddEventHandler(eventMouseClickLeft,
+                                   [&invocationOrder, priority](EventID, const Object&) {
+            invocationOrder.push_back(priority);
+            return true;
+        }, CallEventHandlerOnce::No, priority);
+    }
+
+    // Register a one-time filter that stops the invocation loop ahead of every other handler.
+    blackboard.AddEventHandler(eventMouseClickLeft, [&invocationOrder](EventID, const Object&) {
+        invocationOrder.push_back(100);
+        return false;
+    }, CallEventHandlerOnce::Yes, 100);
+
+    // Create dummy event content.
+    Object dummyObject{};
+
+    // Make sure the filter has stopped every other handler.
+    blackboard.PostEvent(eventMouseClickLeft, dummyObject);
+    REQUIRE(invocationOrder == std::vector<int>{100});
+
+    // Make sure the remaining handlers are invoked by descending priority.
+    invocationOrder.clear();
+    blackboard.PostEvent(eventMouseClickLeft, dummyObject);
+    REQUIRE(invocationOrder == std::vector<int>{10, 10, 0, -5});
+}
+
+TEST_CASE("ParallelEventHandlers", "[BlackboardTest]") {
+    using ParallelSafe = Blackboard::ParallelSafe;
+
+    std::atomic<std::size_t> parallelHandlersCalled = 0;
+    std::size_t serialHandlersCalled = 0;
+
+    Blackboard blackboard;
+
+    // Register a group of parallel-safe handlers, one of which is called once and one of which
+    // stops the invocation loop.
+    for (std::size_t i = 0; i < 8; ++i) {
+        blackboard.AddEventHandler(eventMouseClickLeft,
+                                   [&parallelHandlersCalled](EventID, const Object&) {
+            parallelHandlersCalled++;
+            return true;
+        }, i == 0 ? CallEventHandlerOnce::Yes : CallEventHandlerOnce::No, 1, ParallelSafe::Yes);
+    }
+    const auto stoppingHandlerId =
+            blackboard.AddEventHandler(eventMouseClickLeft,
+                                       [&parallelHandlersCalled](EventID, const Object&) {
+        parallelHandlersCalled++;
+        return false;
+    }, CallEventHandlerOnce::No, 1, ParallelSafe::Yes);
+
+    // Register a serial handler, which runs after the group.
+    blackboard.AddEventHandler(eventMouseClickLeft, [&serialHandlersCalled](EventID,
+                                                                            const Object&) {
+        serialHandlersCalled++;
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    // Create dummy event content.
+    Object dummyObject{};
+
+    // Make sure the whole group has run, but the stop has kept the serial handler from running.
+    blackboard.PostEvent(eventMouseClickLeft, dummyObject);
+    REQUIRE(parallelHandlersCalled == 9);
+    REQUIRE(serialHandlersCalled == 0);
+
+    // Make sure the one-time handler has been removed and the serial handler runs without the stop.
+    blackboard.RemoveEventHandler(eventMouseClickLeft, stoppingHandlerId);
+    blackboard.PostEvent(eventMouseClickLeft, dummyObject);
+    REQUIRE(parallelHandlersCalled == 16);
+    REQUIRE(serialHandlersCalled == 1);
+}
+
+TEST_CASE("ReentrantParallelEventHandlers", "[BlackboardTest]") {
+    using ParallelSafe = Blackboard::ParallelSafe;
+
+    std::atomic<std::size_t> removingHandlerCalls = 0;
+    std::atomic<std::size_t> postingHandlerCalls = 0;
+
+    Blackboard blackboard;
+
+    // Register a parallel-safe handler, which removes itself, and another one, which posts its own
+    // event once.
+    EventHandlerUniqueId removingHandlerId = 0;
+    removingHandlerId = blackboard.AddEventHandler(eventMouseClickLeft,
+                                                   [&](EventID eventId, const Object&) {
+        ++removingHandlerCalls;
+        blackboard.RemoveEventHandler(eventId, removingHandlerId);
+        return true;
+    }, CallEventHandlerOnce::No, 0, ParallelSafe::Yes);
+    std::string replayedString;
+    blackboard.AddEventHandler(eventMouseClickLeft, [&](EventID eventId,
+                                                        const Object& eventContent) {
+        if (postingHandlerCalls++ == 0) {
+            // Posted from the stack, which is gone by the time the event is dispatched.
+            Object postedEventContent;
+            postedEventContent.AddValue(Value{"String"s}, Value{std::string(100, 'x')});
+            blackboard.PostEvent(eventId, postedEventContent);
+        } else {
+            replayedString = eventContent.GetValue(Value{"String"s})->ToString();
+        }
+        return true;
+    }, CallEventHandlerOnce::No, 0, ParallelSafe::Yes);
+
+    // Make sure the event posted by the group is queued instead of deadlocking, and the handler
+    // that removed itself is not invoked again.
+    blackboard.PostEvent(eventMouseClickLeft, Object());
+    REQUIRE(removingHandlerCalls == 1);
+    REQUIRE(postingHandlerCalls == 1);
+
+    const auto queuedEventsReport = blackboard.ProcessQueuedEvents(Blackboard::Duration::max());
+    REQUIRE(queuedEventsReport.processedEvents == 1);
+    REQUIRE(removingHandlerCalls == 1);
+    REQUIRE(postingHandlerCalls == 2);
+
+    // Make sure the queued event carries its own copy of the payload.
+    REQUIRE(replayedString == std::string(100, 'x'));
+}
+
+TEST_CASE("AsyncEventHandlers", "[BlackboardTest]") {
+    using SharedObject = Blackboard::SharedObject;
+
+    // Create an executor that defers tasks until told to run them.
+    struct DeferringExecutor : public Executor {
+        void Execute(Task&& task) override {
+            tasks.push_back(std::move(task));
+        }
+
+        std::vector<Task> tasks;
+    };
+
+    DeferringExecutor deferringExecutor;
+    std::atomic<std::size_t> asyncHandlersCalled = 0;
+    std::size_t errorsReported = 0;
+
+    Blackboard blackboard;
+    blackboard.SetErrorHandler([&errorsReported](EventID eventId, const Object&,
+                                                 DispatchResult dispatchResult) {
+        REQUIRE(eventId == eventMouseClickLeft);
+        REQUIRE(dispatchResult == DispatchResult::HandlerError);
+        errorsReported++;
+    });
+
+    // Register an async handler that inspects the shared payload and one that fails once.
+    blackboard.AddAsyncEventHandler(eventMouseClickLeft,
+                                    [&asyncHandlersCalled](EventID eventId,
+                                                           const SharedObject& eventContent) {
+        REQUIRE(eventId == eventMouseClickLeft);
+        REQUIRE(eventContent->GetValue(Value{"Thirteen"s}) == Value{13.0});
+        asyncHandlersCalled++;
+        return true;
+    }, CallEventHandlerOnce::No);
+    blackboard.AddAsyncEventHandler(eventMouseClickLeft,
+                                    [&asyncHandlersCalled](EventID, const SharedObject&) {
+        asyncHandlersCalled++;
+        return InvocationResult::Error;
+    }, CallEventHandlerOnce::Yes);
+
+    // Post an event whose payload is destroyed before the async handlers are invoked.
+    blackboard.SetExecutor(&deferringExecutor);
+    {
+        Object eventContent{};
+        eventContent.AddValue(Value{"Thirteen"s}, Value{13.0});
+        blackboard.PostEvent(eventMouseClickLeft, eventContent);
+    }
+    REQUIRE(asyncHandlersCalled == 0);
+    REQUIRE(deferringExecutor.tasks.size() == 2);
+    REQUIRE(blackboard.GetPendingAsyncEventHandlerCount() == 2);
+
+    // Make sure the failure is reported on this thread, once the handlers have completed.
+    for (auto& task : deferringExecutor.tasks) {
+        task();
+    }
+    deferringExecutor.tasks.clear();
+    REQUIRE(asyncHandlersCalled == 2);
+    REQUIRE(errorsReported == 0);
+    blackboard.WaitForAsyncEventHandlers();
+    REQUIRE(errorsReported == 1);
+
+    // Make sure the built-in thread pool invokes the remaining handler.
+    blackboard.SetExecutor(nullptr);
+    Object dummyObject{};
+    dummyObject.AddValue(Value{"Thirteen"s}, Value{13.0});
+    blackboard.PostEvent(eventMouseClickLeft, dummyObject);
+    blackboard.WaitForAsyncEventHandlers();
+    REQUIRE(asyncHandlersCalled == 3);
+    REQUIRE(blackboard.GetPendingAsyncEventHandlerCount() == 0);
+}
+
+TEST_CASE("QueuedEventPriorities", "[BlackboardTest]") {
+    using QueuedEventPriority = Blackboard::QueuedEventPriority;
+
+    std::vector<Event> processedEvents;
+    std::size_t missedDeadlinesReported = 0;
+
+    Blackboard blackboard;
+    blackboard.SetErrorHandler([&missedDeadlinesReported](EventID, const Object&,
+                                                          DispatchResult dispatchResult) {
+        REQUIRE(dispatchResult == DispatchResult::DeadlineMissed);
+        missedDeadlinesReported++;
+    });
+
+    for (const auto& event : {"Telemetry1", "Telemetry2", "Control", "Deadline1", "Deadline2",
+                              "Missed", "Critical"}) {
+        blackboard.AddEventHandler(event, [&processedEvents](EventID eventId, const Object&) {
+            processedEvents.emplace_back(eventId);
+            return true;
+        }, CallEventHandlerOnce::No);
+    }
+
+    // Create dummy event content.
+    Object dummyObject{};
+
+    // Post a burst of low-priority events, followed by more urgent ones.
+    const auto now = std::chrono::steady_clock::now();
+    blackboard.PostQueuedEvent("Telemetry1", dummyObject, QueuedEventPriority::Low);
+    blackboard.PostQueuedEvent("Telemetry2", dummyObject, QueuedEventPriority::Low);
+    blackboard.PostQueuedEvent("Control", dummyObject, QueuedEventPriority::High);
+    blackboard.PostQueuedEvent("Deadline2", dummyObject, QueuedEventPriority::Normal,
+                               now + std::chrono::hours(2));
+    blackboard.PostQueuedEvent("Deadline1", dummyObject, QueuedEventPriority::Normal,
+                               now + std::chrono::hours(1));
+    blackboard.PostQueuedEvent("Missed", dummyObject, QueuedEventPriority::Normal,
+                               now - std::chrono::hours(1));
+    blackboard.PostQueuedEvent("Critical", dummyObject, QueuedEventPriority::Critical);
+
+    // Make sure events are processed by priority, then by deadline, then in posting order.
+    const auto queuedEventsReport = blackboard.TryProcessQueuedEvents();
+    REQUIRE(processedEvents == std::vector<Event>{"Critical", "Control", "Missed", "Deadline1",
+                                                  "Deadline2", "Telemetry1", "Telemetry2"});
+    REQUIRE(queuedEventsReport.processedEvents == 7);
+    REQUIRE(queuedEventsReport.failedEvents == 0);
+
+    // Make sure the missed deadline has been reported, but has not been treated as a failure.
+    REQUIRE(queuedEventsReport.missedDeadlines == 1);
+    REQUIRE(missedDeadlinesReported == 1);
+}
+
+TEST_CASE("CancelledAndExpiredQueuedEvents", "[BlackboardTest]") {
+    using QueuedEventPriority = Blackboard::QueuedEventPriority;
+
+    std::vector<Event> processedEvents;
+
+    Blackboard blackboard;
+
+    for (const auto& event : {"Kept", "Cancelled", "Expired", "Alive"}) {
+        blackboard.AddEventHandler(event, [&processedEvents](EventID eventId, const Object&) {
+            processedEvents.emplace_back(eventId);
+            return true;
+        }, CallEventHandlerOnce::No);
+    }
+
+    // Create dummy event content.
+    Object dummyObject{};
+
+    // Post events, one of which is cancelled and one of which expires immediately.
+    blackboard.PostQueuedEvent("Kept", dummyObject);
+    const auto ticket = blackboard.PostQueuedEvent("Cancelled", dummyObject);
+    blackboard.PostQueuedEvent("Expired", dummyObject, QueuedEventPriority::Normal,
+                               Blackboard::noDeadline, std::chrono::nanoseconds(-1));
+    blackboard.PostQueuedEvent("Alive", dummyObject, QueuedEventPriority::Normal,
+                               Blackboard::noDeadline, std::chrono::hours(1));
+    blackboard.CancelQueuedEvent(ticket);
+
+    // Make sure the withdrawn events have been skipped and counted.
+    const auto queuedEventsReport = blackboard.TryProcessQueuedEvents();
+    REQUIRE(processedEvents == std::vector<Event>{"Kept", "Alive"});
+    REQUIRE(queuedEventsReport.processedEvents == 2);
+    REQUIRE(queuedEventsReport.cancelledEvents == 1);
+    REQUIRE(queuedEventsReport.expiredEvents == 1);
+
+    // Make sure cancelling an already processed event has no effect on later ones.
+    blackboard.CancelQueuedEvent(ticket);
+    blackboard.TryProcessQueuedEvents();
+    blackboard.PostQueuedEvent("Cancelled", dummyObject);
+    REQUIRE(blackboard.TryProcessQueuedEvents().processedEvents == 1);
+    REQUIRE(processedEvents.back() == "Cancelled");
+
+    // Make sure the ticket of an event refers to it, even if it is scheduled ahead of events
+    // posted earlier.
+    processedEvents.clear();
+    const auto keptTicket = blackboard.PostQueuedEvent("Kept", dummyObject,
+                                                       QueuedEventPriority::Low);
+    const auto cancelledTicket = blackboard.PostQueuedEvent("Cancelled", dummyObject,
+                                                            QueuedEventPriority::High);
+    REQUIRE(keptTicket != cancelledTicket);
+    blackboard.CancelQueuedEvent(cancelledTicket);
+    REQUIRE(blackboard.TryProcessQueuedEvents().cancelledEvents == 1);
+    REQUIRE(processedEvents == std::vector<Event>{"Kept"});
+
+    // Make sure cancelling processed events, or a ticket that has not been issued, has no effect
+    // on the events issued tickets afterwards, even though they may reuse the same slots.
+    blackboard.CancelQueuedEvent(keptTicket);
+    blackboard.CancelQueuedEvent(cancelledTicket);
+    blackboard.CancelQueuedEvent(std::numeric_limits<Blackboard::QueuedEventTicket>::max());
+    const auto reusedTicket = blackboard.PostQueuedEvent("Kept", dummyObject);
+    blackboard.PostQueuedEvent("Kept", dummyObject);
+    REQUIRE(reusedTicket != keptTicket);
+    REQUIRE(reusedTicket != cancelledTicket);
+    REQUIRE(blackboard.TryProcessQueuedEvents().processedEvents == 2);
+
+    // Make sure an event cancelled after a reused ticket has been issued is still withdrawn.
+    blackboard.CancelQueuedEvent(blackboard.PostQueuedEvent("Cancelled", dummyObject));
+    REQUIRE(blackboard.TryProcessQueuedEvents().cancelledEvents == 1);
+}
+
+TEST_CASE("BudgetedProcessQueuedEvents", "[BlackboardTest]") {
+    std::vector<Event> processedEvents;
+
+    Blackboard blackboard;
+
+    // Register a handler that posts a new queued event while the queue is being processed.
+    Object dummyObject{};
+    blackboard.AddEventHandler(eventMouseClickLeft, [&](EventID eventId, const Object&) {
+        processedEvents.emplace_back(eventId);
+        if (processedEvents.size() == 1) {
+            blackboard.PostQueuedEvent(eventMouseClickRight, dummyObject);
+        }
+        return true;
+    }, CallEventHandlerOnce::No);
+    blackboard.AddEventHandler(eventMouseClickRight, [&](EventID eventId, const Object&) {
+        processedEvents.emplace_back(eventId);
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    for (std::size_t i = 0; i < 5; ++i) {
+        blackboard.PostQueuedEvent(eventMouseClickLeft, dummyObject);
+    }
+
+    // Make sure processing stops at the event budget and reports what is left.
+    auto queuedEventsReport = blackboard.ProcessQueuedEvents(std::chrono::hours(1), 2);
+    REQUIRE(queuedEventsReport.processedEvents == 2);
+    REQUIRE(queuedEventsReport.remainingEvents == 4);
+
+    // Make sure an exhausted time budget processes nothing.
+    queuedEventsReport = blackboard.TryProcessQueuedEvents(std::chrono::nanoseconds(0));
+    REQUIRE(queuedEventsReport.processedEvents == 0);
+    REQUIRE(queuedEventsReport.remainingEvents == 4);
+
+    // Make sure the events left behind are processed ahead of the one posted meanwhile.
+    queuedEventsReport = blackboard.ProcessQueuedEvents(std::chrono::hours(1));
+    REQUIRE(queuedEventsReport.processedEvents == 4);
+    REQUIRE(queuedEventsReport.remainingEvents == 0);
+    REQUIRE(processedEvents == std::vector<Event>{eventMouseClickLeft, eventMouseClickLeft,
+                                                  eventMouseClickLeft, eventMouseClickLeft,
+                                                  eventMouseClickLeft, eventMouseClickRight});
+}
+
+TEST_CASE("BatchEventHandlers", "[BlackboardTest]") {
+    using EventContentSpan = Blackboard::EventContentSpan;
+
+    std::vector<std::size_t> batchSizes;
+    std::vector<Event> processedEvents;
+    double batchTotal = 0.0;
+
+    Blackboard blackboard;
+
+    // Register a batch handler, which sums the payloads, as well as regular handlers.
+    blackboard.AddBatchEventHandler(eventMouseClickLeft, [&](EventID eventId,
+                                                             EventContentSpan eventContents) {
+        REQUIRE(eventId == eventMouseClickLeft);
+        batchSizes.push_back(eventContents.GetSize());
+        for (const Object* eventContent : eventContents) {
+            batchTotal += eventContent->GetValue(Value{"Value"s})->ToNumber();
+        }
+        processedEvents.emplace_back("Batch");
+        return true;
+    }, CallEventHandlerOnce::No);
+    for (const auto& event : {eventMouseClickLeft, eventMouseClickRight}) {
+        blackboard.AddEventHandler(event, [&processedEvents](EventID eventId, const Object&) {
+            processedEvents.emplace_back(eventId);
+            return true;
+        }, CallEventHandlerOnce::No);
+    }
+
+    std::vector<Object> eventContents(5);
+    for (std::size_t i = 0; i < eventContents.size(); ++i) {
+        eventContents[i].AddValue(Value{"Value"s}, Value{static_cast<double>(i)});
+    }
+
+    // Post three events with the same ID, interleaved with a different one before the last.
+    blackboard.PostQueuedEvent(eventMouseClickLeft, eventContents[0]);
+    blackboard.PostQueuedEvent(eventMouseClickLeft, eventContents[1]);
+    blackboard.PostQueuedEvent(eventMouseClickLeft, eventContents[2]);
+    blackboard.PostQueuedEvent(eventMouseClickRight, eventContents[3]);
+    blackboard.PostQueuedEvent(eventMouseClickLeft, eventContents[4]);
+
+    // Make sure the batch is flushed whenever a different event interleaves.
+    blackboard.ProcessQueuedEvents();
+    REQUIRE(batchSizes == std::vector<std::size_t>{3, 1});
+    REQUIRE(batchTotal == 0.0 + 1.0 + 2.0 + 4.0);
+    REQUIRE(processedEvents == std::vector<Event>{eventMouseClickLeft, eventMouseClickLeft,
+                                                  eventMouseClickLeft, "Batch",
+                                                  eventMouseClickRight, eventMouseClickLeft,
+                                                  "Batch"});
+
+    // Make sure events posted without queueing are passed as batches of one.
+    blackboard.PostEvent(eventMouseClickLeft, eventContents[4]);
+    REQUIRE(batchSizes.back() == 1);
+    REQUIRE(batchTotal == 11.0);
+}
+
+TEST_CASE("RemovedBatchEventHandlers", "[BlackboardTest]") {
+    using EventContentSpan = Blackboard::EventContentSpan;
+
+    std::vector<std::size_t> firstBatchSizes;
+    std::vector<std::size_t> secondBatchSizes;
+    std::size_t processedEvents = 0;
+
+    Blackboard blackboard;
+
+    const auto firstBatchHandlerId = blackboard.AddBatchEventHandler(eventMouseClickLeft,
+            [&firstBatchSizes](EventID, EventContentSpan eventContents) {
+        firstBatchSizes.push_back(eventContents.GetSize());
+        return true;
+    }, CallEventHandlerOnce::No);
+    const auto secondBatchHandlerId = blackboard.AddBatchEventHandler(eventMouseClickLeft,
+            [&secondBatchSizes](EventID, EventContentSpan eventContents) {
+        secondBatchSizes.push_back(eventContents.GetSize());
+        return true;
+    }, CallEventHandlerOnce::No);
+    blackboard.AddEventHandler(eventMouseClickLeft, [&processedEvents](EventID, const Object&) {
+        ++processedEvents;
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    // Make sure removing one of the batch handlers keeps batching events for the other.
+    blackboard.RemoveEventHandler(eventMouseClickLeft, firstBatchHandlerId);
+    blackboard.PostQueuedEvent(eventMouseClickLeft, Object());
+    blackboard.PostQueuedEvent(eventMouseClickLeft, Object());
+    blackboard.ProcessQueuedEvents();
+    REQUIRE(firstBatchSizes.empty());
+    REQUIRE(secondBatchSizes == std::vector<std::size_t>{2});
+    REQUIRE(processedEvents == 2);
+
+    // Make sure events are still processed once the last batch handler is removed.
+    blackboard.RemoveEventHandler(eventMouseClickLeft, secondBatchHandlerId);
+    blackboard.PostQueuedEvent(eventMouseClickLeft, Object());
+    blackboard.PostQueuedEvent(eventMouseClickLeft, Object());
+    blackboard.ProcessQueuedEvents();
+    REQUIRE(secondBatchSizes == std::vector<std::size_t>{2});
+    REQUIRE(processedEvents == 4);
+
+    // Make sure batch handlers added afterwards, as well as ones called once, receive batches.
+    blackboard.AddBatchEventHandler(eventMouseClickLeft,
+                                    [&firstBatchSizes](EventID, EventContentSpan eventContents) {
+        firstBatchSizes.push_back(eventContents.GetSize());
+        return true;
+    }, CallEventHandlerOnce::Yes);
+    for (auto i = 0; i < 2; ++i) {
+        blackboard.PostQueuedEvent(eventMouseClickLeft, Object());
+        blackboard.PostQueuedEvent(eventMouseClickLeft, Object());
+        blackboard.ProcessQueuedEvents();
+    }
+    REQUIRE(firstBatchSizes == std::vector<std::size_t>{2});
+    REQUIRE(processedEvents == 8);
+}
+
+TEST_CASE("StoppedBatchedEvents", "[BlackboardTest]") {
+    using EventContentSpan = Blackboard::EventContentSpan;
+
+    std::vector<double> batchedValues;
+
+    Blackboard blackboard;
+
+    // Register a regular handler, ahead of the batch handler, which stops negative payloads.
+    blackboard.AddEventHandler(eventMouseClickLeft, [](EventID, const Object& eventContent) {
+        return eventContent.GetValue(Value{"Value"s})->ToNumber() >= 0.0;
+    }, CallEventHandlerOnce::No, 1);
+    blackboard.AddBatchEventHandler(eventMouseClickLeft,
+                                    [&batchedValues](EventID, EventContentSpan eventContents) {
+        for (const Object* eventContent : eventContents) {
+            batchedValues.push_back(eventContent->GetValue(Value{"Value"s})->ToNumber());
+        }
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    std::vector<Object> eventContents(3);
+    for (std::size_t i = 0; i < eventContents.size(); ++i) {
+        eventContents[i].AddValue(Value{"Value"s}, Value{i == 1 ? -1.0 : static_cast<double>(i)});
+    }
+
+    // Make sure stopped events are withheld from batch handlers when posted without queueing.
+    for (const auto& eventContent : eventContents) {
+        blackboard.PostEvent(eventMouseClickLeft, eventContent);
+    }
+    REQUIRE(batchedValues == std::vector<double>{0.0, 2.0});
+
+    // Make sure stopped events are left out of the batches of queued events as well.
+    batchedValues.clear();
+    for (const auto& eventContent : eventContents) {
+        blackboard.PostQueuedEvent(eventMouseClickLeft, eventContent);
+    }
+    blackboard.ProcessQueuedEvents();
+    REQUIRE(batchedValues == std::vector<double>{0.0, 2.0});
+}
+
+TEST_CASE("EventHandlerInvocationPolicies", "[BlackboardTest]") {
+    using namespace std::chrono_literals;
+    using InvocationPolicy = Blackboard::InvocationPolicy;
+
+    std::size_t rateLimitedInvocations = 0;
+    std::size_t leadingInvocations = 0;
+    std::vector<double> trailingEventContents;
+
+    Blackboard blackboard;
+
+    blackboard.AddEventHandler(eventMouseClickLeft, [&](EventID, const Object&) {
+        ++rateLimitedInvocations;
+        return true;
+    }, CallEventHandlerOnce::No, InvocationPolicy::RateLimit(0.001, 3.0));
+    blackboard.AddEventHandler(eventMouseClickLeft, [&](EventID, const Object&) {
+        ++leadingInvocations;
+        return true;
+    }, CallEventHandlerOnce::No, InvocationPolicy::LeadingDebounce(1h));
+    blackboard.AddEventHandler(eventMouseClickRight, [&](EventID, const Object& eventContent) {
+        trailingEventContents.push_back(eventContent.GetValue(Value{"Value"s})->ToNumber());
+        return true;
+    }, CallEventHandlerOnce::Yes, InvocationPolicy::TrailingDebounce(1ms));
+
+    std::vector<Object> eventContents(5);
+    for (std::size_t i = 0; i < eventContents.size(); ++i) {
+        eventContents[i].AddValue(Value{"Value"s}, Value{static_cast<double>(i)});
+        blackboard.PostEvent(eventMouseClickLeft, eventContents[i]);
+        blackboard.PostEvent(eventMouseClickRight, eventContents[i]);
+    }
+
+    // Make sure only the burst passes the rate limit and only the first event the debounce.
+    REQUIRE(rateLimitedInvocations == 3);
+    REQUIRE(leadingInvocations == 1);
+
+    // Make sure the trailing event is held back until its quiet period has passed.
+    REQUIRE(trailingEventContents.empty());
+    std::this_thread::sleep_for(5ms);
+    REQUIRE(blackboard.TryProcessQueuedEvents().failedEvents == 0);
+    REQUIRE(trailingEventContents == std::vector<double>{4.0});
+
+    // Make sure handlers called once are removed after their trailing event.
+    REQUIRE(!blackboard.HasHandlers(eventMouseClickRight));
+}
+
+TEST_CASE("ReentrantDebouncedEventHandlers", "[BlackboardTest]") {
+    using namespace std::chrono_literals;
+    using InvocationPolicy = Blackboard::InvocationPolicy;
+
+    std::vector<double> trailingEventContents;
+
+    Blackboard blackboard;
+
+    // Register a handler, which processes queued events from within the dispatch of its event,
+    // ahead of a debounced handler of the same event.
+    blackboard.AddEventHandler(eventMouseClickLeft, [&blackboard](EventID, const Object&) {
+        blackboard.ProcessQueuedEvents();
+        return true;
+    }, CallEventHandlerOnce::No, 1);
+    blackboard.AddEventHandler(eventMouseClickLeft, [&](EventID, const Object& eventContent) {
+        trailingEventContents.push_back(eventContent.GetValue(Value{"Value"s})->ToNumber());
+        return true;
+    }, CallEventHandlerOnce::No, InvocationPolicy::TrailingDebounce(1ms));
+
+    std::vector<Object> eventContents(2);
+    for (std::size_t i = 0; i < eventContents.size(); ++i) {
+        eventContents[i].AddValue(Value{"Value"s}, Value{static_cast<double>(i)});
+    }
+
+    // Make sure a due debounced handler of the event being dispatched is deferred, instead of
+    // waiting for the dispatch to end.
+    blackboard.PostEvent(eventMouseClickLeft, eventContents[0]);
+    std::this_thread::sleep_for(5ms);
+    blackboard.PostEvent(eventMouseClickLeft, eventContents[1]);
+    REQUIRE(trailingEventContents.empty());
+
+    std::this_thread::sleep_for(5ms);
+    blackboard.ProcessQueuedEvents();
+    REQUIRE(trailingEventContents == std::vector<double>{1.0});
+}
@@ -0,0 +1,321 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/BoardStore.h"
+#include "Blackboard/Object.h"
+#include "Blackboard/Value.h"
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+
+using namespace std::string_literals;
+using namespace blackboard;
+
+using EventID = Blackboard::EventID;
+using CallEventHandlerOnce = Blackboard::CallEventHandlerOnce;
+
+//--------------------------------------------------------------------------------------------------
+
+static Object MakeEntry(double count) {
+    Object entry;
+    entry.AddValue(Value{"Count"s}, Value{count});
+    return entry;
+}
+
+static double GetCount(const Object* entry) {
+    return entry->GetValue(Value{"Count"s})->ToNumber();
+}
+
+static Object MakeServiceEntry(std::string_view status, double load) {
+    Object entry;
+    entry.AddValue(Value{"Status"s}, Value{status});
+    entry.AddValue(Value{"Load"s}, Value{load});
+    return entry;
+}
+
+static std::set<std::string> ToKeySet(const std::vector<Value>& keys) {
+    std::set<std::string> keySet;
+    for (const auto& key : keys) {
+        keySet.insert(key.ToString());
+    }
+    return keySet;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("BoardStoreSnapshots", "[BoardStoreTest]") {
+    BoardStore boardStore(16);
+    REQUIRE(boardStore.GetVersion() == 0);
+
+    REQUIRE(boardStore.Put(Value{"A"s}, MakeEntry(1.0)) == 1);
+    REQUIRE(boardStore.Put(Value{"B"s}, MakeEntry(2.0)) == 2);
+
+    const auto firstSnapshot = boardStore.GetSnapshot();
+    REQUIRE(firstSnapshot.GetVersion() == 2);
+
+    REQUIRE(boardStore.Put(Value{"A"s}, MakeEntry(3.0)) == 3);
+    REQUIRE(boardStore.Remove(Value{"B"s}) == 4);
+    REQUIRE(boardStore.Put(Value{"C"s}, MakeEntry(4.0)) == 5);
+
+    // Make sure removing a missing entry writes nothing.
+    REQUIRE(boardStore.Remove(Value{"B"s}) == 5);
+    REQUIRE(boardStore.Remove(Value{"D"s}) == 5);
+
+    // Make sure the snapshot does not see any of the later writes.
+    REQUIRE(GetCount(firstSnapshot.Get(Value{"A"s})) == 1.0);
+    REQUIRE(GetCount(firstSnapshot.Get(Value{"B"s})) == 2.0);
+    REQUIRE(firstSnapshot.Get(Value{"C"s}) == nullptr);
+
+    const auto secondSnapshot = boardStore.GetSnapshot();
+    REQUIRE(GetCount(secondSnapshot.Get(Value{"A"s})) == 3.0);
+    REQUIRE(secondSnapshot.Get(Value{"B"s}) == nullptr);
+    REQUIRE(GetCount(secondSnapshot.Get(Value{"C"s})) == 4.0);
+    REQUIRE(secondSnapshot.Get(Value{"D"s}) == nullptr);
+
+    std::map<std::string, double> entries;
+    secondSnapshot.ForEach([&entries](const Value& key, const Object& entry) {
+        entries.emplace(key.ToString(), GetCount(&entry));
+    });
+    REQUIRE(entries == std::map<std::string, double>{{"A", 3.0}, {"C", 4.0}});
+
+    // Make sure a key that was removed can be put again.
+    boardStore.Put(Value{"B"s}, MakeEntry(5.0));
+    REQUIRE(GetCount(boardStore.GetSnapshot().Get(Value{"B"s})) == 5.0);
+    REQUIRE(GetCount(firstSnapshot.Get(Value{"B"s})) == 2.0);
+}
+
+TEST_CASE("BoardStoreReclamation", "[BoardStoreTest]") {
+    BoardStore boardStore(16);
+
+    // Make sure versions that no snapshot can read are reclaimed immediately.
+    for (auto count = 0; count < 10; ++count) {
+        boardStore.Put(Value{"A"s}, MakeEntry(count));
+    }
+    REQUIRE(boardStore.GetRetainedVersionCount() == 0);
+
+    {
+        auto snapshot = boardStore.GetSnapshot();
+        for (auto count = 10; count < 20; ++count) {
+            boardStore.Put(Value{"A"s}, MakeEntry(count));
+        }
+
+        // Make sure the versions written after the snapshot are retained, since they link to the
+        // one it reads.
+        REQUIRE(boardStore.GetRetainedVersionCount() == 10);
+        REQUIRE(GetCount(snapshot.Get(Value{"A"s})) == 9.0);
+
+        auto movedSnapshot = std::move(snapshot);
+        REQUIRE(GetCount(movedSnapshot.Get(Value{"A"s})) == 9.0);
+    }
+
+    // Make sure the versions are reclaimed by the next write once the snapshot is released.
+    boardStore.Put(Value{"A"s}, MakeEntry(20.0));
+    REQUIRE(boardStore.GetRetainedVersionCount() == 0);
+    REQUIRE(GetCount(boardStore.GetSnapshot().Get(Value{"A"s})) == 20.0);
+
+    // Make sure removed keys are kept while a snapshot can read them, and reclaimed afterwards.
+    boardStore.Put(Value{"B"s}, MakeEntry(1.0));
+    REQUIRE(boardStore.GetKeyCount() == 2);
+    {
+        const auto snapshot = boardStore.GetSnapshot();
+        boardStore.Remove(Value{"B"s});
+        REQUIRE(boardStore.GetKeyCount() == 2);
+        REQUIRE(GetCount(snapshot.Get(Value{"B"s})) == 1.0);
+    }
+    boardStore.Put(Value{"A"s}, MakeEntry(21.0));
+    REQUIRE(boardStore.GetKeyCount() == 1);
+    REQUIRE(boardStore.GetSnapshot().Get(Value{"B"s}) == nullptr);
+
+    // Make sure keys that are put again before being reclaimed are kept.
+    boardStore.Put(Value{"B"s}, MakeEntry(2.0));
+    {
+        const auto snapshot = boardStore.GetSnapshot();
+        boardStore.Remove(Value{"B"s});
+        boardStore.Put(Value{"B"s}, MakeEntry(3.0));
+    }
+    boardStore.Put(Value{"A"s}, MakeEntry(22.0));
+    REQUIRE(boardStore.GetKeyCount() == 2);
+    REQUIRE(GetCount(boardStore.GetSnapshot().Get(Value{"B"s})) == 3.0);
+
+    // Make sure churning keys do not accumulate.
+    for (auto count = 0; count < 100; ++count) {
+        boardStore.Put(Value{static_cast<double>(count)}, MakeEntry(count));
+        boardStore.Remove(Value{static_cast<double>(count)});
+    }
+    REQUIRE(boardStore.GetKeyCount() == 2);
+}
+
+TEST_CASE("BoardStoreOverflowSnapshots", "[BoardStoreTest]") {
+    BoardStore boardStore(16);
+    boardStore.Put(Value{"A"s}, MakeEntry(0.0));
+
+    // Make sure snapshots beyond the slots neither block nor lose their versions.
+    std::deque<BoardStore::Snapshot> snapshots;
+    for (std::size_t count = 0; count < BoardStore::maxSnapshots + 2; ++count) {
+        snapshots.push_back(boardStore.GetSnapshot());
+        boardStore.Put(Value{"A"s}, MakeEntry(count + 1));
+    }
+    for (std::size_t count = 0; count < snapshots.size(); ++count) {
+        REQUIRE(GetCount(snapshots[count].Get(Value{"A"s})) == count);
+    }
+
+    // Make sure the oldest version pinned by the overflow snapshots holds back reclamation.
+    for (std::size_t count = 0; count < BoardStore::maxSnapshots; ++count) {
+        snapshots.pop_front();
+    }
+    boardStore.Put(Value{"A"s}, MakeEntry(100.0));
+    REQUIRE(boardStore.GetRetainedVersionCount() == 3);
+    REQUIRE(GetCount(snapshots.front().Get(Value{"A"s})) == BoardStore::maxSnapshots);
+
+    snapshots.clear();
+    boardStore.Put(Value{"A"s}, MakeEntry(101.0));
+    REQUIRE(boardStore.GetRetainedVersionCount() == 0);
+}
+
+TEST_CASE("BoardStoreChangeEvents", "[BoardStoreTest]") {
+    std::vector<Object> changes;
+
+    Blackboard blackboard;
+    BoardStore boardStore(blackboard, "StoreChanged", 16);
+
+    // Make sure writes without handlers of the change event still succeed.
+    boardStore.Put(Value{"A"s}, MakeEntry(1.0));
+
+    blackboard.AddEventHandler("StoreChanged", [&changes](EventID, const Object& change) {
+        changes.push_back(change);
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    boardStore.Put(Value{"A"s}, MakeEntry(2.0));
+    boardStore.Remove(Value{"A"s});
+    boardStore.Remove(Value{"A"s});
+
+    REQUIRE(changes.size() == 2);
+    REQUIRE(changes[0].GetValue(Value{"Key"s}) == Value{"A"s});
+    REQUIRE(changes[0].GetValue(Value{"Version"s}) == Value{2.0});
+    REQUIRE(changes[0].GetValue(Value{"Deleted"s}) == Value{false});
+    REQUIRE(changes[0].GetValue(Value{"Entry"s}) == Value{MakeEntry(2.0)});
+    REQUIRE(changes[1].GetValue(Value{"Version"s}) == Value{3.0});
+    REQUIRE(changes[1].GetValue(Value{"Deleted"s}) == Value{true});
+    REQUIRE(!changes[1].GetValue(Value{"Entry"s}));
+
+    // Make sure handlers of the change event may write to the store.
+    blackboard.AddEventHandler("StoreChanged", [&boardStore](EventID, const Object& change) {
+        if (change.GetValue(Value{"Key"s}) == Value{"B"s}) {
+            boardStore.Put(Value{"C"s}, MakeEntry(4.0));
+        }
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    boardStore.Put(Value{"B"s}, MakeEntry(3.0));
+    REQUIRE(changes.size() == 4);
+    REQUIRE(GetCount(boardStore.GetSnapshot().Get(Value{"C"s})) == 4.0);
+}
+
+TEST_CASE("BoardStoreIndexes", "[BoardStoreTest]") {
+    using KeySet = std::set<std::string>;
+
+    BoardStore boardStore(16);
+    boardStore.Put(Value{"A"s}, MakeServiceEntry("Healthy", 0.5));
+    boardStore.Put(Value{"B"s}, MakeServiceEntry("Degraded", 0.95));
+
+    // Make sure indexes include the entries that existed before them.
+    boardStore.AddIndex(Value{"Status"s}, BoardStore::IndexKind::Hash);
+    boardStore.AddIndex(Value{"Load"s}, BoardStore::IndexKind::Ordered);
+    REQUIRE(ToKeySet(boardStore.FindKeys(Value{"Status"s}, Value{"Degraded"s})) == KeySet{"B"});
+    REQUIRE(ToKeySet(boardStore.FindKeys(Value{"Load"s}, Value{0.5})) == KeySet{"A"});
+
+    boardStore.Put(Value{"C"s}, MakeServiceEntry("Degraded", 0.9));
+    boardStore.Put(Value{"D"s}, MakeServiceEntry("Healthy", 0.1));
+    boardStore.Put(Value{"E"s}, Object());
+
+    // Make sure range queries include their lower bound only, and may be open on either side.
+    REQUIRE(ToKeySet(boardStore.FindKeysInRange(Value{"Load"s}, Value{0.5}, Value{0.95})) ==
+            KeySet{"A", "C"});
+    REQUIRE(ToKeySet(boardStore.FindKeysInRange(Value{"Load"s}, Value{0.9}, std::nullopt)) ==
+            KeySet{"B", "C"});
+    REQUIRE(ToKeySet(boardStore.FindKeysInRange(Value{"Load"s}, std::nullopt, Value{0.5})) ==
+            KeySet{"D"});
+    REQUIRE(boardStore.FindKeysInRange(Value{"Load"s}, Value{0.9}, Value{0.9}).empty());
+
+    // Make sure updates and removals are reflected in the indexes.
+    boardStore.Put(Value{"B"s}, MakeServiceEntry("Healthy", 0.2));
+    boardStore.Remove(Value{"C"s});
+    REQUIRE(boardStore.FindKeys(Value{"Status"s}, Value{"Degraded"s}).empty());
+    REQUIRE(ToKeySet(boardStore.FindKeys(Value{"Status"s}, Value{"Healthy"s})) ==
+            KeySet{"A", "B", "D"});
+    REQUIRE(boardStore.FindKeysInRange(Value{"Load"s}, Value{0.9}, std::nullopt).empty());
+    REQUIRE(ToKeySet(boardStore.FindKeysInRange(Value{"Load"s}, std::nullopt, Value{0.5})) ==
+            KeySet{"B", "D"});
+
+    // Make sure open ranges stop at values of another type.
+    boardStore.Put(Value{"F"s},
+                   MakeServiceEntry("Unknown", 0.0).AddValue(Value{"Load"s}, Value{"High"s}));
+    REQUIRE(ToKeySet(boardStore.FindKeysInRange(Value{"Load"s}, Value{0.0}, std::nullopt)) ==
+            KeySet{"A", "B", "D"});
+    REQUIRE(ToKeySet(boardStore.FindKeysInRange(Value{"Load"s}, Value{""s}, std::nullopt)) ==
+            KeySet{"F"});
+}
+
+TEST_CASE("BoardStoreConcurrentSnapshots", "[BoardStoreTest]") {
+    constexpr auto numReaders = 4;
+    constexpr auto numWrites = 2000;
+
+    BoardStore boardStore(16);
+    boardStore.Put(Value{"A"s}, MakeEntry(0.0));
+    boardStore.Put(Value{"B"s}, MakeEntry(0.0));
+
+    // Each count is written to A before B, so a snapshot that sees them differ by anything else is
+    // not consistent. Keys are also put and removed in between, so that readers traverse keys that
+    // are being reclaimed.
+    std::atomic<bool> writing = true;
+    std::atomic<std::size_t> inconsistentSnapshots = 0;
+    std::vector<std::thread> readers;
+    for (auto reader = 0; reader < numReaders; ++reader) {
+        readers.emplace_back([&boardStore, &writing, &inconsistentSnapshots] {
+            while (writing.load()) {
+                const auto snapshot = boardStore.GetSnapshot();
+                const auto first = GetCount(snapshot.Get(Value{"A"s}));
+                std::this_thread::yield();
+                const auto second = GetCount(snapshot.Get(Value{"B"s}));
+                if (first != second && first != second + 1) {
+                    inconsistentSnapshots.fetch_add(1);
+                }
+                auto entries = 0;
+                snapshot.ForEach([&entries](const Value&, const Object&) {
+                    ++entries;
+                });
+                if (entries < 2) {
+                    inconsistentSnapshots.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    for (auto write = 1; write <= numWrites; ++write) {
+        boardStore.Put(Value{"A"s}, MakeEntry(write));
+        boardStore.Put(Value{"B"s}, MakeEntry(write));
+        boardStore.Put(Value{static_cast<double>(write)}, MakeEntry(write));
+        boardStore.Remove(Value{static_cast<double>(write)});
+    }
+    writing.store(false);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    REQUIRE(inconsistentSnapshots.load() == 0);
+    REQUIRE(boardStore.GetVersion() == 2 + 4 * numWrites);
+
+    boardStore.Remove(Value{"A"s});
+    REQUIRE(boardStore.GetRetainedVersionCount() == 0);
+}
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/Channel.h"
+#include "Blackboard/Object.h"
+
+#include <cstddef>
+
+#include <catch.hpp>
+
+using namespace blackboard;
+
+using EventID = Blackboard::EventID;
+using CallEventHandlerOnce = Blackboard::CallEventHandlerOnce;
+using InvocationResult = Blackboard::InvocationResult;
+
+//--------------------------------------------------------------------------------------------------
+
+struct PositionUpdate {
+    double x;
+    double y;
+};
+
+static constexpr Channel<PositionUpdate> positionChannel{"pos"_evt};
+
+static_assert("pos"_evt == HashChannelName("pos"));
+static_assert("pos"_evt != "rot"_evt);
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("PostChannelEvent", "[ChannelTest]") {
+    Blackboard blackboard;
+
+    // Register typed handlers, one of which stops the invocation loop.
+    double sumX = 0, sumY = 0;
+    blackboard.AddEventHandler(positionChannel, [&sumX](const PositionUpdate& positionUpdate) {
+        sumX += positionUpdate.x;
+        return true;
+    }, CallEventHandlerOnce::No);
+    blackboard.AddEventHandler(positionChannel, [](const PositionUpdate& positionUpdate) {
+        return positionUpdate.x < 0 ? InvocationResult::Stop : InvocationResult::Continue;
+    }, CallEventHandlerOnce::No);
+    const auto eventHandlerId = blackboard.AddEventHandler(
+        positionChannel, [&sumY](const PositionUpdate& positionUpdate) {
+            sumY += positionUpdate.y;
+            return true;
+        }, CallEventHandlerOnce::No);
+
+    // Post typed events and verify that the payload has been delivered as is.
+    blackboard.PostEvent(positionChannel, PositionUpdate{1.5, 2.5});
+    REQUIRE(sumX == 1.5);
+    REQUIRE(sumY == 2.5);
+
+    blackboard.PostEvent(positionChannel, PositionUpdate{-1.0, 2.5});
+    REQUIRE(sumX == 0.5);
+    REQUIRE(sumY == 2.5);
+
+    // Remove the last handler and make sure it is no longer called.
+    blackboard.RemoveEventHandler(positionChannel, eventHandlerId);
+    blackboard.PostEvent(positionChannel, PositionUpdate{1.0, 1.0});
+    REQUIRE(sumX == 1.5);
+    REQUIRE(sumY == 2.5);
+
+    // Clear the remaining handlers.
+    blackboard.ClearEventHandlers(positionChannel);
+    blackboard.PostEvent(positionChannel, PositionUpdate{1.0, 1.0});
+    REQUIRE(sumX == 1.5);
+}
+
+TEST_CASE("ChannelsAndDynamicEvents", "[ChannelTest]") {
+    Blackboard blackboard;
+
+    // Register a typed and a dynamic handler under the same name.
+    std::size_t typedHandlerCalled = 0, dynamicHandlerCalled = 0;
+    blackboard.AddEventHandler(positionChannel, [&](const PositionUpdate&) {
+        typedHandlerCalled++;
+        return true;
+    }, CallEventHandlerOnce::Yes);
+    blackboard.AddEventHandler("pos", [&](EventID eventId, const Object&) {
+        REQUIRE(eventId == "pos");
+        dynamicHandlerCalled++;
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    // Make sure each kind of event reaches only its own handlers.
+    blackboard.PostEvent("pos", Object{});
+    REQUIRE(typedHandlerCalled == 0);
+    REQUIRE(dynamicHandlerCalled == 1);
+
+    blackboard.PostEvent(positionChannel, PositionUpdate{0, 0});
+    blackboard.PostEvent(positionChannel, PositionUpdate{0, 0});
+    REQUIRE(typedHandlerCalled == 1);
+    REQUIRE(dynamicHandlerCalled == 1);
+}
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/DerivedValues.h"
+#include "Blackboard/Object.h"
+#include "Blackboard/Value.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch.hpp>
+
+using namespace std::string_literals;
+using namespace blackboard;
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("LazyDerivedValues", "[DerivedValuesTest]") {
+    DerivedValues derivedValues;
+    derivedValues.SetInput("Hits", Value{3.0});
+    derivedValues.SetInput("Misses", Value{1.0});
+
+    derivedValues.Define("Total", [](DerivedValueReader& reader) {
+        return Value{reader.Get("Hits").ToNumber() + reader.Get("Misses").ToNumber()};
+    });
+    derivedValues.Define("HitRatio", [](DerivedValueReader& reader) {
+        return Value{reader.Get("Hits").ToNumber() / reader.Get("Total").ToNumber()};
+    });
+    derivedValues.Define("Healthy", [](DerivedValueReader& reader) {
+        return Value{reader.Get("HitRatio").ToNumber() >= 0.5};
+    });
+
+    // Make sure nothing is computed until read.
+    REQUIRE(derivedValues.GetComputationCount() == 0);
+    REQUIRE(derivedValues.Get("Healthy") == Value{true});
+    REQUIRE(derivedValues.GetComputationCount() == 3);
+
+    // Make sure reading again, or setting an input to the same value, recomputes nothing.
+    derivedValues.SetInput("Hits", Value{3.0});
+    REQUIRE(derivedValues.Get("Healthy") == Value{true});
+    REQUIRE(derivedValues.GetComputationCount() == 3);
+
+    // Make sure changes are not computed until read, and values are recomputed only once.
+    derivedValues.SetInput("Hits", Value{1.0});
+    derivedValues.SetInput("Misses", Value{3.0});
+    REQUIRE(derivedValues.GetComputationCount() == 3);
+    REQUIRE(derivedValues.Get("HitRatio") == Value{0.25});
+    REQUIRE(derivedValues.Get("Healthy") == Value{false});
+    REQUIRE(derivedValues.GetComputationCount() == 6);
+
+    // Make sure an unchanged total cuts the recomputation of what depends only on it off.
+    derivedValues.Define("TotalIsLarge", [](DerivedValueReader& reader) {
+        return Value{reader.Get("Total").ToNumber() > 10.0};
+    });
+    REQUIRE(derivedValues.Get("TotalIsLarge") == Value{false});
+    REQUIRE(derivedValues.GetComputationCount() == 7);
+
+    derivedValues.SetInput("Hits", Value{2.0});
+    derivedValues.SetInput("Misses", Value{2.0});
+    REQUIRE(derivedValues.Get("TotalIsLarge") == Value{false});
+    REQUIRE(derivedValues.GetComputationCount() == 8);
+
+    // Make sure values that are neither set nor defined are undefined, until they are.
+    derivedValues.Define("Penalty", [](DerivedValueReader& reader) {
+        const auto weight = reader.Get("Weight");
+        return Value{weight.GetType() == "Undefined" ? 0.0 : weight.ToNumber()};
+    });
+    REQUIRE(derivedValues.Get("Penalty") == Value{0.0});
+    derivedValues.SetInput("Weight", Value{2.0});
+    REQUIRE(derivedValues.Get("Penalty") == Value{2.0});
+}
+
+TEST_CASE("DynamicDerivedValueDependencies", "[DerivedValuesTest]") {
+    DerivedValues derivedValues;
+    derivedValues.SetInput("UseBackup", Value{false});
+    derivedValues.SetInput("Primary", Value{1.0});
+    derivedValues.SetInput("Backup", Value{2.0});
+
+    derivedValues.Define("Reading", [](DerivedValueReader& reader) {
+        return reader.Get("UseBackup").ToBoolean() ? reader.Get("Backup") : reader.Get("Primary");
+    });
+    REQUIRE(derivedValues.Get("Reading") == Value{1.0});
+
+    // Make sure values that were not read last time are not dependencies.
+    derivedValues.SetInput("Backup", Value{3.0});
+    REQUIRE(derivedValues.Get("Reading") == Value{1.0});
+    REQUIRE(derivedValues.GetComputationCount() == 1);
+
+    derivedValues.SetInput("UseBackup", Value{true});
+    REQUIRE(derivedValues.Get("Reading") == Value{3.0});
+    derivedValues.SetInput("Primary", Value{4.0});
+    REQUIRE(derivedValues.Get("Reading") == Value{3.0});
+    REQUIRE(derivedValues.GetComputationCount() == 2);
+}
+
+TEST_CASE("ObservedDerivedValues", "[DerivedValuesTest]") {
+    Blackboard blackboard;
+    DerivedValues derivedValues;
+    derivedValues.BindInput("Temperature", blackboard, "Reading", Value{"Temperature"s});
+
+    derivedValues.Define("Overheated", [](DerivedValueReader& reader) {
+        const auto temperature = reader.Get("Temperature");
+        return Value{temperature.GetType() == "Number" && temperature.ToNumber() > 80.0};
+    });
+    derivedValues.Define("Alarm", [](DerivedValueReader& reader) {
+        return Value{reader.Get("Overheated").ToBoolean() ? "On"s : "Off"s};
+    });
+
+    // Make sure observers are notified of the current values, then only of changes, in order of
+    // depth.
+    std::vector<std::pair<std::string, Value>> notifications;
+    derivedValues.Observe("Alarm", [&notifications](std::string_view name, const Value& value) {
+        notifications.emplace_back(name, value);
+    });
+    derivedValues.Observe("Overheated", [&notifications](std::string_view name,
+                                                         const Value& value) {
+        notifications.emplace_back(name, value);
+    });
+    REQUIRE(notifications.size() == 2);
+    REQUIRE(notifications[0] == std::pair<std::string, Value>{"Alarm", Value{"Off"s}});
+    REQUIRE(notifications[1] == std::pair<std::string, Value>{"Overheated", Value{false}});
+
+    Object reading;
+    for (const auto temperature : {50.0, 60.0, 90.0, 95.0}) {
+        reading.AddValue(Value{"Temperature"s}, Value{temperature});
+        blackboard.PostEvent("Reading", reading);
+    }
+    REQUIRE(notifications.size() == 4);
+    REQUIRE(notifications[2] == std::pair<std::string, Value>{"Overheated", Value{true}});
+    REQUIRE(notifications[3] == std::pair<std::string, Value>{"Alarm", Value{"On"s}});
+    REQUIRE(derivedValues.GetComputationCount() == 2 + 4 + 1);
+}
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/EventFilter.h"
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <catch.hpp>
+
+using EventFilter = blackboard::EventFilter;
+
+// Well-mixed hashes from a fixed seed, since the values of std::hash are implementation-defined
+// and not necessarily mixed at all.
+static std::vector<std::size_t> MakeHashes(std::size_t count) {
+    std::mt19937_64 generator(13);
+    std::vector<std::size_t> hashes(count);
+    for (auto& hash : hashes) {
+        hash = static_cast<std::size_t>(generator());
+    }
+    return hashes;
+}
+
+TEST_CASE("EventFilterInsertAndRemove", "[EventFilterTest]") {
+    const auto hashes = MakeHashes(100);
+    EventFilter eventFilter;
+
+    for (const auto hash : hashes) {
+        eventFilter.Insert(hash);
+    }
+
+    // Make sure there are no false negatives.
+    for (const auto hash : hashes) {
+        REQUIRE(eventFilter.MayContain(hash));
+    }
+
+    // Make sure duplicate insertions are counted.
+    eventFilter.Insert(hashes[0]);
+    eventFilter.Remove(hashes[0]);
+    REQUIRE(eventFilter.MayContain(hashes[0]));
+
+    // Make sure an emptied filter contains nothing.
+    for (const auto hash : hashes) {
+        eventFilter.Remove(hash);
+    }
+    for (const auto hash : hashes) {
+        REQUIRE(!eventFilter.MayContain(hash));
+    }
+}
+
+TEST_CASE("EventFilterFalsePositives", "[EventFilterTest]") {
+    const auto hashes = MakeHashes(10100);
+    EventFilter eventFilter;
+
+    for (std::size_t i = 0; i < 100; ++i) {
+        eventFilter.Insert(hashes[i]);
+    }
+
+    // Make sure the rate of false positives stays close to the expected one, which is below 1%
+    // for 100 events, hence around 90 out of 10000, with a standard deviation below 10.
+    std::size_t falsePositives = 0;
+    for (std::size_t i = 100; i < hashes.size(); ++i) {
+        falsePositives += eventFilter.MayContain(hashes[i]);
+    }
+    REQUIRE(falsePositives < 300);
+}
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/InlineFunction.h"
+#include "Blackboard/Object.h"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+
+#include <catch.hpp>
+
+using namespace blackboard;
+
+using EventID = Blackboard::EventID;
+using EventHandler = Blackboard::EventHandler;
+using CallEventHandlerOnce = Blackboard::CallEventHandlerOnce;
+
+//--------------------------------------------------------------------------------------------------
+
+static int Twice(int value) {
+    return 2 * value;
+}
+
+struct Counter {
+    bool OnEvent(EventID, const Object&) {
+        ++timesCalled;
+        return true;
+    }
+
+    int Add(int value) {
+        total += value;
+        return total;
+    }
+
+    std::size_t timesCalled = 0;
+    int total = 0;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("InlineFunctionStorage", "[InlineFunctionTest]") {
+    using Function = InlineFunction<int(int), 64>;
+
+    int a = 1, b = 2, c = 3, d = 4, e = 5;
+    auto fivePointers = [&a, &b, &c, &d, &e](int value) { return value + a + b + c + d + e; };
+    auto oversized = [array = std::array<char, 128>{}](int value) { return value + array[0]; };
+
+    REQUIRE(Function::storesInline<decltype(fivePointers)>);
+    REQUIRE(!Function::storesInline<decltype(oversized)>);
+
+    Function inlineFunction = fivePointers;
+    Function heapFunction = oversized;
+
+    REQUIRE(inlineFunction(1) == 16);
+    REQUIRE(heapFunction(1) == 1);
+
+    Function emptyFunction;
+    REQUIRE(!emptyFunction);
+    emptyFunction = heapFunction;
+    REQUIRE(emptyFunction);
+    REQUIRE(emptyFunction(2) == 2);
+}
+
+TEST_CASE("InlineFunctionCopyAndMove", "[InlineFunctionTest]") {
+    using Function = InlineFunction<long(), 32>;
+
+    auto shared = std::make_shared<long>(13);
+    Function function = [shared] { return shared.use_count(); };
+    REQUIRE(function() == 2);
+
+    Function copy = function;
+    REQUIRE(copy() == 3);
+
+    Function moved = std::move(copy);
+    REQUIRE(!copy);
+    REQUIRE(moved() == 3);
+
+    moved = nullptr;
+    REQUIRE(function() == 2);
+
+    function = nullptr;
+    REQUIRE(shared.use_count() == 1);
+}
+
+TEST_CASE("InlineFunctionBind", "[InlineFunctionTest]") {
+    using Function = InlineFunction<int(int), 16>;
+
+    Counter counter;
+
+    auto freeFunction = Function::Bind<&Twice>();
+    auto memberFunction = Function::Bind<&Counter::Add>(&counter);
+
+    REQUIRE(freeFunction(4) == 8);
+    REQUIRE(memberFunction(4) == 4);
+    REQUIRE(memberFunction(5) == 9);
+    REQUIRE(counter.total == 9);
+}
+
+TEST_CASE("AddInlineEventHandler", "[InlineFunctionTest]") {
+    Blackboard blackboard;
+    Counter counter;
+    Object dummyObject{};
+
+    std::size_t a = 0, b = 0, c = 0, d = 0, e = 0;
+    auto eventHandler = [&a, &b, &c, &d, &e](EventID, const Object&) {
+        ++a, ++b, ++c, ++d, ++e;
+        return true;
+    };
+    REQUIRE(EventHandler::storesInline<decltype(eventHandler)>);
+
+    blackboard.AddEventHandler("Inline", eventHandler, CallEventHandlerOnce::No);
+    blackboard.AddEventHandler<&Counter::OnEvent>("Inline", &counter, CallEventHandlerOnce::Yes);
+
+    blackboard.PostEvent("Inline", dummyObject);
+    blackboard.PostEvent("Inline", dummyObject);
+
+    REQUIRE(a + b + c + d + e == 10);
+    REQUIRE(counter.timesCalled == 1);
+}
@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/KnowledgeBase.h"
+#include "Blackboard/Object.h"
+#include "Blackboard/ThreadPool.h"
+#include "Blackboard/Value.h"
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch.hpp>
+
+using namespace std::string_literals;
+using namespace blackboard;
+
+using FactSpan = KnowledgeBase::FactSpan;
+using RunAgendaAutomatically = KnowledgeBase::RunAgendaAutomatically;
+using KnowledgeTransaction = blackboard::KnowledgeTransaction;
+
+//--------------------------------------------------------------------------------------------------
+
+static Object MakeOrder(const std::string& customer, const std::string& status) {
+    Object order;
+    order.AddValue(Value{"Customer"s}, Value{customer});
+    order.AddValue(Value{"Status"s}, Value{status});
+    return order;
+}
+
+static Object MakeCustomer(const std::string& id, const std::string& tier) {
+    Object customer;
+    customer.AddValue(Value{"Id"s}, Value{id});
+    customer.AddValue(Value{"Tier"s}, Value{tier});
+    return customer;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("KnowledgeSourceJoins", "[KnowledgeBaseTest]") {
+    std::vector<std::pair<FactId, FactId>> matches;
+
+    KnowledgeBase knowledgeBase;
+    knowledgeBase.AddKnowledgeSource({
+        FactPattern("Order").Where(Value{"Status"s}, Value{"Open"s})
+                            .Bind(Value{"Customer"s}, "customer"),
+        FactPattern("Customer").Where(Value{"Tier"s}, Value{"Gold"s})
+                               .Bind(Value{"Id"s}, "customer")
+    }, [&matches](FactSpan facts) {
+        REQUIRE(facts.GetSize() == 2);
+        matches.emplace_back(facts[0]->id, facts[1]->id);
+    });
+
+    const auto alice = knowledgeBase.AssertFact("Customer", MakeCustomer("Alice", "Gold"));
+    const auto aliceOrder = knowledgeBase.AssertFact("Order", MakeOrder("Alice", "Open"));
+    const auto bobOrder = knowledgeBase.AssertFact("Order", MakeOrder("Bob", "Open"));
+    REQUIRE(matches == std::vector<std::pair<FactId, FactId>>{{aliceOrder, alice}});
+
+    // Make sure a fact completing a match from the other side activates the source as well.
+    const auto bob = knowledgeBase.AssertFact("Customer", MakeCustomer("Bob", "Gold"));
+    REQUIRE(matches.size() == 2);
+    REQUIRE(matches.back() == std::make_pair(bobOrder, bob));
+
+    // Make sure only new matches activate the source again.
+    knowledgeBase.UpdateFact(aliceOrder, MakeOrder("Alice", "Closed"));
+    knowledgeBase.AssertFact("Customer", MakeCustomer("Carol", "Silver"));
+    REQUIRE(matches.size() == 2);
+    knowledgeBase.UpdateFact(aliceOrder, MakeOrder("Alice", "Open"));
+    REQUIRE(matches.size() == 3);
+    REQUIRE(matches.back() == std::make_pair(aliceOrder, alice));
+
+    // Make sure retracted facts no longer take part in matches.
+    knowledgeBase.RetractFact(bob);
+    REQUIRE(knowledgeBase.GetFact(bob) == nullptr);
+    knowledgeBase.AssertFact("Order", MakeOrder("Bob", "Open"));
+    REQUIRE(matches.size() == 3);
+    REQUIRE(knowledgeBase.GetFactCount() == 5);
+}
+
+TEST_CASE("KnowledgeSourceChaining", "[KnowledgeBaseTest]") {
+    std::vector<std::string> pairs;
+    std::size_t alerts = 0;
+
+    KnowledgeBase knowledgeBase;
+
+    Object person;
+    person.AddValue(Value{"City"s}, Value{"Athens"s});
+    for (const auto& name : {"Anna"s, "Nikos"s}) {
+        person.AddValue(Value{"Name"s}, Value{name});
+        knowledgeBase.AssertFact("Person", person);
+    }
+
+    // Make sure sources added later match the facts asserted so far, and never match a fact with
+    // itself.
+    knowledgeBase.AddKnowledgeSource({
+        FactPattern("Person").Bind(Value{"City"s}, "city"),
+        FactPattern("Person").Bind(Value{"City"s}, "city")
+    }, [&pairs, &knowledgeBase](FactSpan facts) {
+        pairs.push_back(facts[0]->content.GetValue(Value{"Name"s})->ToString() + "-" +
+                        facts[1]->content.GetValue(Value{"Name"s})->ToString());
+        knowledgeBase.AssertFact("Neighbours", Object());
+    });
+    REQUIRE(pairs == std::vector<std::string>{"Anna-Nikos", "Nikos-Anna"});
+
+    // Make sure facts asserted by actions activate other sources.
+    knowledgeBase.AddKnowledgeSource({FactPattern("Neighbours")}, [&alerts](FactSpan) {
+        ++alerts;
+    });
+    REQUIRE(alerts == 2);
+
+    person.AddValue(Value{"Name"s}, Value{"Eleni"s});
+    knowledgeBase.AssertFact("Person", person);
+    REQUIRE(pairs.size() == 6);
+    REQUIRE(alerts == 6);
+}
+
+TEST_CASE("KnowledgeSourceAgenda", "[KnowledgeBaseTest]") {
+    std::vector<std::string> activations;
+
+    KnowledgeBase knowledgeBase(RunAgendaAutomatically::No);
+    knowledgeBase.SetActivationScoring([](KnowledgeSourceId, FactSpan facts) {
+        const auto isOpen = facts[0]->content.GetValue(Value{"Status"s})->ToString() == "Open";
+        return isOpen ? 1.0 : 0.0;
+    });
+    knowledgeBase.AddKnowledgeSource({FactPattern("Order")}, [&activations](FactSpan facts) {
+        activations.push_back(facts[0]->content.GetValue(Value{"Customer"s})->ToString());
+    });
+
+    knowledgeBase.AssertFact("Order", MakeOrder("Alice", "Closed"));
+    const auto bobOrder = knowledgeBase.AssertFact("Order", MakeOrder("Bob", "Open"));
+    const auto carolOrder = knowledgeBase.AssertFact("Order", MakeOrder("Carol", "Closed"));
+    knowledgeBase.AssertFact("Order", MakeOrder("Dave", "Open"));
+    REQUIRE(knowledgeBase.GetPendingActivationCount() == 4);
+
+    // Make sure activations of retracted or updated facts are withdrawn, and updated ones rescored.
+    knowledgeBase.RetractFact(bobOrder);
+    knowledgeBase.UpdateFact(carolOrder, MakeOrder("Carol", "Open"));
+    REQUIRE(knowledgeBase.GetPendingActivationCount() == 3);
+
+    // Make sure an exhausted budget runs nothing, and the agenda runs by score otherwise.
+    REQUIRE(knowledgeBase.RunAgenda(std::chrono::nanoseconds(0)) == 0);
+    REQUIRE(knowledgeBase.RunAgenda() == 3);
+    REQUIRE(activations == std::vector<std::string>{"Dave", "Carol", "Alice"});
+    REQUIRE(knowledgeBase.GetPendingActivationCount() == 0);
+}
+
+TEST_CASE("SpeculativeKnowledgeSources", "[KnowledgeBaseTest]") {
+    ThreadPool threadPool(3);
+    KnowledgeBase knowledgeBase(RunAgendaAutomatically::No);
+
+    // Increments of the same counter conflict through the counter they match.
+    knowledgeBase.AddKnowledgeSource({
+        FactPattern("Increment").Bind(Value{"Counter"s}, "counter"),
+        FactPattern("Counter").Bind(Value{"Name"s}, "counter")
+    }, [](FactSpan facts, KnowledgeTransaction& transaction) {
+        auto counter = facts[1]->content;
+        counter.AddValue(Value{"Count"s},
+                         Value{counter.GetValue(Value{"Count"s})->ToNumber() + 1.0});
+        transaction.UpdateFact(facts[1]->id, counter);
+        transaction.RetractFact(facts[0]->id);
+    });
+
+    Object counter;
+    counter.AddValue(Value{"Count"s}, Value{0.0});
+    std::vector<FactId> counters;
+    for (const auto& name : {"A"s, "B"s, "C"s, "D"s}) {
+        counter.AddValue(Value{"Name"s}, Value{name});
+        counters.push_back(knowledgeBase.AssertFact("Counter", counter));
+
+        Object increment;
+        increment.AddValue(Value{"Counter"s}, Value{name});
+        for (int i = 0; i < 3; ++i) {
+            knowledgeBase.AssertFact("Increment", increment);
+        }
+    }
+
+    // Make sure every increment is applied exactly once.
+    REQUIRE(knowledgeBase.RunAgendaInParallel(threadPool) == 12);
+    for (const auto counterId : counters) {
+        const auto& content = knowledgeBase.GetFact(counterId)->content;
+        REQUIRE(content.GetValue(Value{"Count"s})->ToNumber() == 3.0);
+    }
+    REQUIRE(knowledgeBase.GetFactCount() == 4);
+
+    // Items are matched on their own, but conflict through the total they all read.
+    Object total;
+    total.AddValue(Value{"Sum"s}, Value{0.0});
+    const auto totalId = knowledgeBase.AssertFact("Total", total);
+    knowledgeBase.AddKnowledgeSource({FactPattern("Item")},
+                                     [totalId](FactSpan facts, KnowledgeTransaction& transaction) {
+        auto total = *transaction.ReadFact(totalId);
+        const auto sum = total.GetValue(Value{"Sum"s})->ToNumber() +
+                         facts[0]->content.GetValue(Value{"Value"s})->ToNumber();
+        total.AddValue(Value{"Sum"s}, Value{sum});
+        transaction.UpdateFact(totalId, total);
+    });
+
+    Object item;
+    for (int i = 1; i <= 10; ++i) {
+        item.AddValue(Value{"Value"s}, Value{static_cast<double>(i)});
+        knowledgeBase.AssertFact("Item", item);
+    }
+
+    // Make sure conflicting activations are retried instead of losing updates.
+    REQUIRE(knowledgeBase.RunAgendaInParallel(threadPool) == 10);
+    REQUIRE(knowledgeBase.GetFact(totalId)->content.GetValue(Value{"Sum"s})->ToNumber() == 55.0);
+    REQUIRE(knowledgeBase.GetRetriedActivationCount() == 9);
+}
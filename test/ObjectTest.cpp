@@ -8,6 +8,7 @@
 
 using Object = blackboard::Object;
 using Value = blackboard::Value;
+using KeyPath = blackboard::KeyPath;
 
 using namespace std::string_literals;
 
@@ -63,6 +64,19 @@ TEST_CASE("RemoveValue", "[ObjectTest]") {
     REQUIRE(object.GetValue(stringValue)->ToNumber() == 13);
 }
 
+TEST_CASE("ClearObject", "[ObjectTest]") {
+    Object object{};
+    object.AddValue(Value{"Thirteen"s}, Value{13.0});
+
+    // Make sure a cleared object is empty, and can be refilled.
+    object.Clear();
+    REQUIRE(object == Object{});
+
+    object.AddValue(Value{"Fourteen"s}, Value{14.0});
+    REQUIRE(!object.GetValue(Value{"Thirteen"s}));
+    REQUIRE(object.GetValue(Value{"Fourteen"s})->ToNumber() == 14);
+}
+
 TEST_CASE("ObjectOperatorEqual", "[ObjectTest]") {
     Value stringValue{"Thirteen"s};
     Value numberValue{13.0};
@@ -77,3 +91,84 @@ TEST_CASE("ObjectOperatorEqual", "[ObjectTest]") {
 
     REQUIRE(objectFirst == objectSecond);
 }
+
+TEST_CASE("ObjectAssignment", "[ObjectTest]") {
+    Value stringValue{"Thirteen"s};
+    Value numberValue{13.0};
+
+    Object objectFirst{};
+    objectFirst.AddValue(stringValue, numberValue);
+
+    Object objectSecond{};
+    objectSecond.AddValue(numberValue, stringValue);
+
+    // Make sure copying replaces the values of the assigned object.
+    objectSecond = objectFirst;
+    REQUIRE(objectSecond == objectFirst);
+    REQUIRE(!objectSecond.GetValue(numberValue));
+
+    // Make sure an object that has been moved from can still be assigned to.
+    Object objectThird{std::move(objectSecond)};
+    objectSecond = objectFirst;
+    REQUIRE(objectSecond == objectFirst);
+    REQUIRE(objectThird == objectFirst);
+
+    objectThird.AddValue(numberValue, stringValue);
+    objectFirst = std::move(objectThird);
+    REQUIRE(objectFirst.GetValue(numberValue)->ToString() == "Thirteen");
+}
+
+TEST_CASE("ObjectDiffAndPatch", "[ObjectTest]") {
+    Value xValue{"X"s};
+    Value yValue{"Y"s};
+    Value poseValue{"Pose"s};
+    Value nameValue{"Name"s};
+
+    Object pose{};
+    pose.AddValue(xValue, Value{1.0});
+    pose.AddValue(yValue, Value{2.0});
+
+    Object objectFirst{};
+    objectFirst.AddValue(poseValue, Value{pose});
+    objectFirst.AddValue(nameValue, Value{"Robot"s});
+
+    REQUIRE(objectFirst.GetValueAt({poseValue, yValue})->ToNumber() == 2.0);
+    REQUIRE(!objectFirst.GetValueAt({poseValue, nameValue}));
+    REQUIRE(!objectFirst.GetValueAt({nameValue, xValue}));
+
+    // Make sure equal objects produce no changes.
+    REQUIRE(objectFirst.Diff(objectFirst).empty());
+
+    Object objectSecond{objectFirst};
+    pose.AddValue(yValue, Value{3.0});
+    objectSecond.AddValue(poseValue, Value{pose});
+    objectSecond.RemoveValue(nameValue);
+
+    // Make sure only the nested value that changed is included, along with the removed one.
+    auto delta = objectFirst.Diff(objectSecond);
+    REQUIRE(delta.size() == 2);
+    for (const auto& change : delta) {
+        if (change.keyPath == KeyPath{poseValue, yValue}) {
+            REQUIRE(change.value == Value{3.0});
+        } else {
+            REQUIRE(change.keyPath == KeyPath{nameValue});
+            REQUIRE(!change.value);
+        }
+    }
+
+    Object patchedObject{objectFirst};
+    patchedObject.Patch(delta);
+    REQUIRE(patchedObject == objectSecond);
+
+    // Make sure only the requested key paths are compared.
+    REQUIRE(objectFirst.Diff(objectSecond, {{poseValue, xValue}}).empty());
+    delta = objectFirst.Diff(objectSecond, {{poseValue}});
+    REQUIRE(delta.size() == 1);
+    REQUIRE(delta[0].keyPath == KeyPath{poseValue, yValue});
+
+    // Make sure patching creates the missing nested objects, and ignores missing removals.
+    Object emptyObject{};
+    emptyObject.Patch({{{poseValue, xValue}, Value{5.0}}, {{nameValue, xValue}, {}}});
+    REQUIRE(emptyObject.GetValueAt({poseValue, xValue})->ToNumber() == 5.0);
+    REQUIRE(!emptyObject.GetValue(nameValue));
+}
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/Object.h"
+#include "Blackboard/Pipeline.h"
+#include "Blackboard/Value.h"
+
+#include <string>
+#include <vector>
+
+#include <catch.hpp>
+
+using namespace std::string_literals;
+using namespace blackboard;
+
+using Event = Blackboard::Event;
+using EventID = Blackboard::EventID;
+using CallEventHandlerOnce = Blackboard::CallEventHandlerOnce;
+
+//--------------------------------------------------------------------------------------------------
+
+static Object MakeReading(double reading) {
+    Object eventContent;
+    eventContent.AddValue(Value{"Reading"s}, Value{reading});
+    return eventContent;
+}
+
+static double GetReading(const Object& eventContent) {
+    return eventContent.GetValue(Value{"Reading"s})->ToNumber();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("PipelineFilterMapMerge", "[PipelineTest]") {
+    std::vector<double> results;
+    std::size_t filterInvocations = 0;
+
+    Blackboard blackboard;
+    blackboard.AddEventHandler("Result", [&results](EventID, const Object& eventContent) {
+        results.push_back(GetReading(eventContent));
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    const auto eventHandlerIds = Pipeline("Sensor")
+        .Filter([&filterInvocations](const Object& eventContent) {
+            ++filterInvocations;
+            return GetReading(eventContent) > 1.0;
+        })
+        .Map([](const Object& eventContent, Object& mappedEventContent) {
+            mappedEventContent.AddValue(Value{"Reading"s}, Value{GetReading(eventContent) * 10.0});
+        })
+        .Merge("Calibrated")
+        .PostTo(blackboard, "Result");
+    REQUIRE(eventHandlerIds.size() == 2);
+
+    blackboard.PostEvent("Sensor", MakeReading(1.0));
+    blackboard.PostEvent("Sensor", MakeReading(2.0));
+    blackboard.PostEvent("Calibrated", MakeReading(3.0));
+    blackboard.PostEvent("Sensor", MakeReading(4.0));
+
+    // Make sure merged events skip the stages that precede the merge.
+    REQUIRE(results == std::vector<double>{20.0, 3.0, 40.0});
+    REQUIRE(filterInvocations == 3);
+
+    // Make sure the handler of each event can be removed separately.
+    blackboard.RemoveEventHandler("Sensor", eventHandlerIds[0]);
+    blackboard.PostEvent("Sensor", MakeReading(5.0));
+    blackboard.PostEvent("Calibrated", MakeReading(6.0));
+    REQUIRE(results == std::vector<double>{20.0, 3.0, 40.0, 6.0});
+}
+
+TEST_CASE("PipelineMapFields", "[PipelineTest]") {
+    std::vector<Object> results;
+
+    Blackboard blackboard;
+    blackboard.AddEventHandler("Result", [&results](EventID, const Object& eventContent) {
+        results.push_back(eventContent);
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    // Map readings above and below zero to different fields.
+    Pipeline("Sensor")
+        .Map([](const Object& eventContent, Object& mappedEventContent) {
+            const auto reading = GetReading(eventContent);
+            mappedEventContent.AddValue(Value{reading >= 0.0 ? "Above"s : "Below"s},
+                                        Value{reading});
+        })
+        .PostTo(blackboard, "Result");
+
+    blackboard.PostEvent("Sensor", MakeReading(1.0));
+    blackboard.PostEvent("Sensor", MakeReading(-1.0));
+
+    // Make sure each output carries only the fields set by the mapper for its own event.
+    REQUIRE(results.size() == 2);
+    REQUIRE(results[0] == Object().AddValue(Value{"Above"s}, Value{1.0}));
+    REQUIRE(results[1] == Object().AddValue(Value{"Below"s}, Value{-1.0}));
+}
+
+TEST_CASE("PipelineForEach", "[PipelineTest]") {
+    std::vector<Event> events;
+
+    Blackboard blackboard;
+    Pipeline("Left")
+        .Merge("Right")
+        .Filter([](const Object& eventContent) { return GetReading(eventContent) >= 0.0; })
+        .ForEach(blackboard, [&events](EventID eventId, const Object&) {
+            events.emplace_back(eventId);
+            return true;
+        }, CallEventHandlerOnce::Yes);
+
+    // Make sure the fused handler receives the original event IDs, and is removed once called.
+    blackboard.PostEvent("Right", MakeReading(-1.0));
+    blackboard.PostEvent("Left", MakeReading(1.0));
+    blackboard.PostEvent("Left", MakeReading(2.0));
+    REQUIRE(events == std::vector<Event>{"Left"});
+    REQUIRE(!blackboard.HasHandlers("Left"));
+    REQUIRE(!blackboard.HasHandlers("Right"));
+}
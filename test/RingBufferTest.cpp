@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/RingBuffer.h"
+
+#include <string>
+
+#include <catch.hpp>
+
+using namespace blackboard;
+
+TEST_CASE("RingBufferPushAndPop", "[RingBufferTest]") {
+    RingBuffer<int> ringBuffer(3);
+    REQUIRE(ringBuffer.IsEmpty());
+    REQUIRE(ringBuffer.GetCapacity() == 3);
+
+    ringBuffer.Push() = 1;
+    ringBuffer.Push() = 2;
+    REQUIRE(ringBuffer.GetSize() == 2);
+    REQUIRE(ringBuffer.Front() == 1);
+    REQUIRE(ringBuffer.Back() == 2);
+
+    ringBuffer.Pop();
+    REQUIRE(ringBuffer.Front() == 2);
+
+    ringBuffer.Pop();
+    REQUIRE(ringBuffer.IsEmpty());
+}
+
+TEST_CASE("RingBufferOverwrite", "[RingBufferTest]") {
+    RingBuffer<std::string> ringBuffer(3);
+
+    for (int i = 0; i < 5; ++i) {
+        ringBuffer.Push() = std::to_string(i);
+    }
+
+    // Make sure only the newest elements have been kept, from oldest to newest.
+    REQUIRE(ringBuffer.IsFull());
+    REQUIRE(ringBuffer[0] == "2");
+    REQUIRE(ringBuffer[1] == "3");
+    REQUIRE(ringBuffer[2] == "4");
+
+    // Make sure the overwritten slot is handed out with its previous value.
+    auto& slot = ringBuffer.Push();
+    REQUIRE(slot == "2");
+    slot = "5";
+    REQUIRE(ringBuffer.Front() == "3");
+    REQUIRE(ringBuffer.Back() == "5");
+
+    ringBuffer.Clear();
+    REQUIRE(ringBuffer.IsEmpty());
+}
@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/Object.h"
+#include "Blackboard/SequenceDetector.h"
+#include "Blackboard/Value.h"
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch.hpp>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+using namespace blackboard;
+
+//--------------------------------------------------------------------------------------------------
+
+static Object MakeEvent(std::string_view key, double sequence = 0.0) {
+    Object eventContent;
+    eventContent.AddValue(Value{"Key"s}, Value{key});
+    eventContent.AddValue(Value{"Sequence"s}, Value{sequence});
+    return eventContent;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("CorrelatedSequences", "[SequenceDetectorTest]") {
+    Blackboard blackboard;
+    SequenceDetector sequenceDetector(blackboard);
+    sequenceDetector.AddPattern(SequencePattern().Then("Login")
+                                                 .Without("Logout")
+                                                 .Then("Purchase")
+                                                 .CorrelatedBy(Value{"Key"s}),
+                                "LoginThenPurchase");
+
+    std::vector<Object> matches;
+    blackboard.AddEventHandler("LoginThenPurchase",
+                               [&matches](Blackboard::EventID, const Object& eventContent) {
+        matches.push_back(eventContent);
+        return true;
+    }, Blackboard::CallEventHandlerOnce::No);
+
+    // Make sure only events with the same key advance a partial match.
+    blackboard.PostEvent("Login", MakeEvent("Alice", 1.0));
+    blackboard.PostEvent("Purchase", MakeEvent("Bob", 2.0));
+    REQUIRE(matches.empty());
+    REQUIRE(sequenceDetector.GetPartialMatchCount() == 1);
+
+    blackboard.PostEvent("Purchase", MakeEvent("Alice", 3.0));
+    REQUIRE(matches.size() == 1);
+
+    // Make sure the match carries its key and the payloads of its steps, in order.
+    const auto& match = matches.back();
+    REQUIRE(*match.GetValue(Value{"Key"s}) == Value{"Alice"s});
+    const auto events = match.GetValue(Value{"Events"s});
+    REQUIRE(events->ToObject().GetValue(Value{0.0})->ToObject() == MakeEvent("Alice", 1.0));
+    REQUIRE(events->ToObject().GetValue(Value{1.0})->ToObject() == MakeEvent("Alice", 3.0));
+
+    // Make sure a partial match takes each transition only once, and is removed afterwards.
+    blackboard.PostEvent("Purchase", MakeEvent("Alice", 4.0));
+    REQUIRE(matches.size() == 1);
+    REQUIRE(sequenceDetector.GetPartialMatchCount() == 0);
+
+    // Make sure negations block partial matches with the same key only.
+    blackboard.PostEvent("Login", MakeEvent("Alice"));
+    blackboard.PostEvent("Login", MakeEvent("Bob"));
+    REQUIRE(sequenceDetector.GetPartialMatchCount() == 2);
+
+    blackboard.PostEvent("Logout", MakeEvent("Alice"));
+    REQUIRE(sequenceDetector.GetPartialMatchCount() == 1);
+
+    blackboard.PostEvent("Purchase", MakeEvent("Alice"));
+    blackboard.PostEvent("Purchase", MakeEvent("Bob"));
+    REQUIRE(matches.size() == 2);
+    REQUIRE(*matches.back().GetValue(Value{"Key"s}) == Value{"Bob"s});
+
+    // Make sure events missing the key take no part in any match.
+    blackboard.PostEvent("Login", Object());
+    REQUIRE(sequenceDetector.GetPartialMatchCount() == 0);
+}
+
+TEST_CASE("SharedSequenceStates", "[SequenceDetectorTest]") {
+    Blackboard blackboard;
+    SequenceDetector sequenceDetector(blackboard);
+    sequenceDetector.AddPattern(SequencePattern().Then("A").Then("B"), "AB");
+    sequenceDetector.AddPattern(SequencePattern().Then("A").Then("B").Then("C"), "ABC");
+    sequenceDetector.AddPattern(SequencePattern().Then("A").Then("C"), "AC");
+
+    // Make sure patterns with the same prefix share its states.
+    REQUIRE(sequenceDetector.GetStateCount() == 5);
+
+    std::vector<std::string> matches;
+    for (const auto matchEventId : {"AB", "ABC", "AC"}) {
+        blackboard.AddEventHandler(matchEventId,
+                                   [&matches](Blackboard::EventID eventId, const Object&) {
+            matches.emplace_back(eventId);
+            return true;
+        }, Blackboard::CallEventHandlerOnce::No);
+    }
+
+    // Make sure a single partial match advances along every branch of a shared state.
+    blackboard.PostEvent("A", Object());
+    blackboard.PostEvent("B", Object());
+    REQUIRE(matches == std::vector<std::string>{"AB"});
+
+    blackboard.PostEvent("C", Object());
+    REQUIRE(matches == std::vector<std::string>{"AB", "ABC", "AC"});
+    REQUIRE(sequenceDetector.GetPartialMatchCount() == 0);
+
+    // Make sure partial matches are not advanced by the event that creates them.
+    matches.clear();
+    sequenceDetector.AddPattern(SequencePattern().Then("D").Then("D"), "DD");
+    blackboard.AddEventHandler("DD", [&matches](Blackboard::EventID eventId, const Object&) {
+        matches.emplace_back(eventId);
+        return true;
+    }, Blackboard::CallEventHandlerOnce::No);
+
+    blackboard.PostEvent("D", Object());
+    REQUIRE(matches.empty());
+    blackboard.PostEvent("D", Object());
+    REQUIRE(matches == std::vector<std::string>{"DD"});
+}
+
+TEST_CASE("SequenceWindows", "[SequenceDetectorTest]") {
+    Blackboard blackboard;
+    SequenceDetector sequenceDetector(blackboard);
+    sequenceDetector.AddPattern(SequencePattern().Then("Request")
+                                                 .Then("Response")
+                                                 .Within(1h)
+                                                 .CorrelatedBy(Value{"Key"s}),
+                                "RequestAnswered");
+
+    auto matches = 0;
+    blackboard.AddEventHandler("RequestAnswered", [&matches](Blackboard::EventID, const Object&) {
+        ++matches;
+        return true;
+    }, Blackboard::CallEventHandlerOnce::No);
+
+    for (const auto key : {"1", "2", "3"}) {
+        blackboard.PostEvent("Request", MakeEvent(key));
+    }
+    REQUIRE(sequenceDetector.GetPartialMatchCount() == 3);
+
+    // Make sure partial matches are kept within their window.
+    sequenceDetector.Advance(std::chrono::steady_clock::now());
+    REQUIRE(sequenceDetector.GetPartialMatchCount() == 3);
+
+    blackboard.PostEvent("Response", MakeEvent("1"));
+    REQUIRE(matches == 1);
+    REQUIRE(sequenceDetector.GetPartialMatchCount() == 2);
+
+    // Make sure partial matches are evicted once their window expires, and never match afterwards.
+    sequenceDetector.Advance(std::chrono::steady_clock::now() + 2h);
+    REQUIRE(sequenceDetector.GetPartialMatchCount() == 0);
+    REQUIRE(sequenceDetector.GetEvictedPartialMatchCount() == 2);
+
+    blackboard.PostEvent("Response", MakeEvent("2"));
+    REQUIRE(matches == 1);
+
+    // Make sure partial matches reusing the slots of evicted ones still match.
+    blackboard.PostEvent("Request", MakeEvent("4"));
+    blackboard.PostEvent("Response", MakeEvent("4"));
+    REQUIRE(matches == 2);
+    REQUIRE(sequenceDetector.GetEvictedPartialMatchCount() == 2);
+}
+
+TEST_CASE("BoundedPartialMatches", "[SequenceDetectorTest]") {
+    Blackboard blackboard;
+    SequenceDetector sequenceDetector(blackboard, 2);
+    sequenceDetector.AddPattern(SequencePattern().Then("Request").Then("Response"),
+                                "RequestAnswered");
+
+    std::vector<Object> matches;
+    blackboard.AddEventHandler("RequestAnswered",
+                               [&matches](Blackboard::EventID, const Object& eventContent) {
+        matches.push_back(eventContent);
+        return true;
+    }, Blackboard::CallEventHandlerOnce::No);
+
+    // Make sure the oldest partial match of a full state is evicted to make room for a new one.
+    for (const auto key : {"1", "2", "3"}) {
+        blackboard.PostEvent("Request", MakeEvent(key));
+    }
+    REQUIRE(sequenceDetector.GetPartialMatchCount() == 2);
+    REQUIRE(sequenceDetector.GetEvictedPartialMatchCount() == 1);
+
+    blackboard.PostEvent("Response", MakeEvent("4"));
+    REQUIRE(matches.size() == 2);
+    for (std::size_t i = 0; i < matches.size(); ++i) {
+        const auto events = matches[i].GetValue(Value{"Events"s});
+        REQUIRE(events->ToObject().GetValue(Value{0.0})->ToObject() ==
+                MakeEvent(i == 0 ? "2" : "3"));
+        REQUIRE(events->ToObject().GetValue(Value{1.0})->ToObject() == MakeEvent("4"));
+    }
+    REQUIRE(sequenceDetector.GetPartialMatchCount() == 0);
+
+    // Make sure partial matches removed otherwise leave room for new ones.
+    for (const auto key : {"5", "6"}) {
+        blackboard.PostEvent("Request", MakeEvent(key));
+    }
+    REQUIRE(sequenceDetector.GetPartialMatchCount() == 2);
+    REQUIRE(sequenceDetector.GetEvictedPartialMatchCount() == 1);
+}
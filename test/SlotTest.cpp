@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/Channel.h"
+#include "Blackboard/Slot.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+
+using namespace blackboard;
+
+using CallEventHandlerOnce = Blackboard::CallEventHandlerOnce;
+
+//--------------------------------------------------------------------------------------------------
+
+struct Pose {
+    double x;
+    double y;
+    double heading;
+    std::uint8_t status;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("SlotStoreAndLoad", "[SlotTest]") {
+    Slot<double> temperature(20.5);
+    REQUIRE(temperature.Load() == 20.5);
+    REQUIRE(temperature.GetVersion() == 0);
+
+    temperature.Store(21.0);
+    temperature.Store(21.5);
+    REQUIRE(temperature.Load() == 21.5);
+    REQUIRE(temperature.GetVersion() == 2);
+
+    // Make sure values that are not a multiple of a word are copied whole.
+    Slot<Pose> pose;
+    REQUIRE(pose.Load().x == 0.0);
+
+    pose.Store({1.0, 2.0, 0.5, 3});
+    const auto storedPose = pose.Load();
+    REQUIRE(storedPose.x == 1.0);
+    REQUIRE(storedPose.y == 2.0);
+    REQUIRE(storedPose.heading == 0.5);
+    REQUIRE(storedPose.status == 3);
+
+    // Make sure slots without a blackboard post nothing.
+    REQUIRE(!pose.PostChange());
+}
+
+TEST_CASE("SlotChangeNotifications", "[SlotTest]") {
+    constexpr auto temperatureChanged = Channel<double>("TemperatureChanged");
+
+    std::vector<double> changes;
+
+    Blackboard blackboard;
+    Slot<double> temperature(blackboard, temperatureChanged);
+
+    blackboard.AddEventHandler(temperatureChanged, [&changes](const double& temperature) {
+        changes.push_back(temperature);
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    // Make sure nothing is posted without any store since the last change.
+    REQUIRE(!temperature.PostChange());
+
+    // Make sure stores are batched into a single change carrying the latest value.
+    temperature.Store(1.0);
+    temperature.Store(2.0);
+    temperature.Store(3.0);
+    REQUIRE(changes.empty());
+    REQUIRE(temperature.PostChange());
+    REQUIRE(!temperature.PostChange());
+
+    temperature.Store(4.0);
+    REQUIRE(temperature.PostChange());
+    REQUIRE(changes == std::vector<double>{3.0, 4.0});
+}
+
+TEST_CASE("SlotConcurrentReaders", "[SlotTest]") {
+    constexpr auto numReaders = 4;
+    constexpr auto numStores = 100000;
+
+    Slot<Pose> pose;
+
+    // Every pose is stored with all of its fields equal, so a reader that sees them differ has
+    // read a torn value.
+    std::atomic<bool> storing = true;
+    std::atomic<std::size_t> tornReads = 0;
+    std::vector<std::thread> readers;
+    for (auto reader = 0; reader < numReaders; ++reader) {
+        readers.emplace_back([&pose, &storing, &tornReads] {
+            auto previousX = 0.0;
+            while (storing.load()) {
+                const auto loadedPose = pose.Load();
+                if (loadedPose.x != loadedPose.y || loadedPose.x != loadedPose.heading ||
+                        loadedPose.x < previousX) {
+                    tornReads.fetch_add(1);
+                }
+                previousX = loadedPose.x;
+            }
+        });
+    }
+
+    for (auto store = 1; store <= numStores; ++store) {
+        const auto value = static_cast<double>(store);
+        pose.Store({value, value, value, 0});
+    }
+    storing.store(false);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    REQUIRE(tornReads.load() == 0);
+    REQUIRE(pose.Load().x == numStores);
+    REQUIRE(pose.GetVersion() == numStores);
+}
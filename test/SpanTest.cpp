@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/Span.h"
+
+#include <vector>
+
+#include <catch.hpp>
+
+using namespace blackboard;
+
+TEST_CASE("SpanAccess", "[SpanTest]") {
+    std::vector<int> elements{1, 2, 3};
+
+    Span<const int> span(elements.data(), elements.size());
+    REQUIRE(!span.IsEmpty());
+    REQUIRE(span.GetSize() == 3);
+    REQUIRE(span.GetData() == elements.data());
+    REQUIRE(span[2] == 3);
+
+    int sum = 0;
+    for (const auto element : span) {
+        sum += element;
+    }
+    REQUIRE(sum == 6);
+
+    Span<int> emptySpan;
+    REQUIRE(emptySpan.IsEmpty());
+    REQUIRE(emptySpan.begin() == emptySpan.end());
+}
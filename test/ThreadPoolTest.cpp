@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/ThreadPool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+
+using namespace blackboard;
+
+TEST_CASE("ThreadPoolExecute", "[ThreadPoolTest]") {
+    std::atomic<std::size_t> tasksRun = 0;
+
+    {
+        ThreadPool threadPool(4);
+        REQUIRE(threadPool.GetThreadCount() == 4);
+
+        for (std::size_t i = 0; i < 100; ++i) {
+            threadPool.Execute([&tasksRun] { tasksRun++; });
+        }
+    }
+
+    // Make sure every task has been run before the pool was destroyed.
+    REQUIRE(tasksRun == 100);
+}
+
+TEST_CASE("ThreadPoolParallelFor", "[ThreadPoolTest]") {
+    ThreadPool threadPool(3);
+
+    std::vector<std::size_t> timesInvoked(1000, 0);
+    std::set<std::thread::id> threadIds;
+    std::mutex threadIdsMutex;
+
+    threadPool.ParallelFor(timesInvoked.size(), [&](std::size_t index) {
+        timesInvoked[index]++;
+        const std::lock_guard<std::mutex> lock(threadIdsMutex);
+        threadIds.insert(std::this_thread::get_id());
+    });
+
+    // Make sure every index has been invoked exactly once, and only by the pool or this thread.
+    for (const auto times : timesInvoked) {
+        REQUIRE(times == 1);
+    }
+    REQUIRE(threadIds.size() <= 4);
+
+    // Make sure empty and single ranges are invoked on the calling thread.
+    std::size_t invocations = 0;
+    threadPool.ParallelFor(0, [&invocations](std::size_t) { invocations++; });
+    REQUIRE(invocations == 0);
+    threadPool.ParallelFor(1, [&invocations](std::size_t) { invocations++; });
+    REQUIRE(invocations == 1);
+}
@@ -7,6 +7,7 @@
 #include <functional>
 #include <stdexcept>
 #include <cstddef>
+#include <utility>
 
 #include <catch.hpp>
 
@@ -92,6 +93,22 @@ TEST_CASE("ValueGetType", "[ValueTest]") {
     REQUIRE(objectValue.GetType() == "Object");
 }
 
+TEST_CASE("ValueIsType", "[ValueTest]") {
+    Value undefinedValue{};
+    Value numberValue{13.0};
+    Value stringValue{"Thirteen"s};
+    Value booleanValue{true};
+    Value referenceValue{reinterpret_cast<void*>(0xDEAFBEEF)};
+    Value objectValue{Object{}};
+
+    REQUIRE((undefinedValue.IsUndefined() && !undefinedValue.IsNumber()));
+    REQUIRE((numberValue.IsNumber() && !numberValue.IsString()));
+    REQUIRE((stringValue.IsString() && !stringValue.IsBoolean()));
+    REQUIRE((booleanValue.IsBoolean() && !booleanValue.IsReference()));
+    REQUIRE((referenceValue.IsReference() && !referenceValue.IsObject()));
+    REQUIRE((objectValue.IsObject() && !objectValue.IsUndefined()));
+}
+
 TEST_CASE("ValueOperatorEqual", "[ValueTest]") {
     Value stringValue{};
     stringValue.FromString("Thirteen");
@@ -112,6 +129,35 @@ TEST_CASE("ValueOperatorEqual", "[ValueTest]") {
     REQUIRE(valueFirst == valueSecond);
 }
 
+TEST_CASE("ValueMove", "[ValueTest]") {
+    Object object{};
+    object.AddValue(Value{"Key"s}, Value{13.0});
+
+    // Make sure moving takes over the string or object of the source, and leaves it undefined.
+    Value stringValue{"Thirteen"s};
+    const auto string = &stringValue.ToString();
+    Value movedStringValue{std::move(stringValue)};
+    REQUIRE(&movedStringValue.ToString() == string);
+    REQUIRE(stringValue.GetType() == "Undefined");
+
+    Value objectValue{object};
+    const auto movedObject = &objectValue.ToObject();
+    Value movedObjectValue{};
+    movedObjectValue = std::move(objectValue);
+    REQUIRE(&movedObjectValue.ToObject() == movedObject);
+    REQUIRE(movedObjectValue.ToObject() == object);
+    REQUIRE(objectValue.GetType() == "Undefined");
+
+    // Make sure moving a value onto a value holding an object or string replaces it.
+    movedObjectValue = std::move(movedStringValue);
+    REQUIRE(&movedObjectValue.ToString() == string);
+
+    // Make sure moving a value onto itself leaves it intact.
+    auto& sameValue = movedObjectValue;
+    movedObjectValue = std::move(sameValue);
+    REQUIRE(movedObjectValue.ToString() == "Thirteen");
+}
+
 TEST_CASE("ValueOperatorBool", "[ValueTest]") {
     Value undefinedValue{};
     Value trueNumberValue{13.0};
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright (c) 2020 Vangelis Tsiatsianas
+
+#include "Blackboard/Blackboard.h"
+#include "Blackboard/Object.h"
+#include "Blackboard/Value.h"
+#include "Blackboard/WindowAggregator.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <catch.hpp>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+using namespace blackboard;
+
+using EventID = Blackboard::EventID;
+using CallEventHandlerOnce = Blackboard::CallEventHandlerOnce;
+
+//--------------------------------------------------------------------------------------------------
+
+static void PostSamples(Blackboard& blackboard, const std::vector<double>& samples) {
+    Object eventContent;
+    for (const auto sample : samples) {
+        eventContent.AddValue(Value{"Latency"s}, Value{sample});
+        blackboard.PostEvent("Request", eventContent);
+    }
+}
+
+static double GetResult(const Object& result, const std::string& key) {
+    return result.GetValue(Value{key})->ToNumber();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("TumblingWindowAggregator", "[WindowAggregatorTest]") {
+    std::vector<Object> results;
+
+    Blackboard blackboard;
+    blackboard.AddEventHandler("RequestLatency", [&results](EventID, const Object& result) {
+        results.push_back(result);
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    WindowAggregator windowAggregator(blackboard, "Request", Value{"Latency"s}, "RequestLatency",
+                                      1h, {50.0, 99.5});
+    const auto start = std::chrono::steady_clock::now();
+
+    PostSamples(blackboard, {4.0, 2.0, 5.0, 1.0, 3.0});
+
+    // Make sure payloads without a number field are ignored.
+    Object otherEventContent;
+    otherEventContent.AddValue(Value{"Latency"s}, Value{"Unknown"s});
+    blackboard.PostEvent("Request", otherEventContent);
+
+    // Make sure nothing is posted until the window closes.
+    REQUIRE(results.empty());
+    windowAggregator.Advance(start + 1h);
+
+    REQUIRE(results.size() == 1);
+    REQUIRE(GetResult(results[0], "Count") == 5.0);
+    REQUIRE(GetResult(results[0], "Sum") == 15.0);
+    REQUIRE(GetResult(results[0], "Min") == 1.0);
+    REQUIRE(GetResult(results[0], "Max") == 5.0);
+    REQUIRE(GetResult(results[0], "Mean") == 3.0);
+    REQUIRE(GetResult(results[0], "P50") == 3.0);
+    REQUIRE(GetResult(results[0], "P99.5") == 5.0);
+
+    // Make sure empty windows are not posted.
+    windowAggregator.Advance(start + 5h);
+    REQUIRE(results.size() == 1);
+
+    PostSamples(blackboard, {7.0});
+    windowAggregator.Advance(start + 6h);
+    REQUIRE(results.size() == 2);
+    REQUIRE(GetResult(results[1], "Count") == 1.0);
+    REQUIRE(GetResult(results[1], "P50") == 7.0);
+}
+
+TEST_CASE("SlidingWindowAggregator", "[WindowAggregatorTest]") {
+    std::vector<Object> results;
+
+    Blackboard blackboard;
+    blackboard.AddEventHandler("RequestLatency", [&results](EventID, const Object& result) {
+        results.push_back(result);
+        return true;
+    }, CallEventHandlerOnce::No);
+
+    WindowAggregator windowAggregator(blackboard, "Request", Value{"Latency"s}, "RequestLatency",
+                                      3h, 1h, {100.0});
+    const auto start = std::chrono::steady_clock::now();
+
+    // Make sure each pane closes a window spanning the last three panes.
+    PostSamples(blackboard, {1.0, 2.0});
+    windowAggregator.Advance(start + 1h);
+    PostSamples(blackboard, {10.0});
+    windowAggregator.Advance(start + 2h);
+    windowAggregator.Advance(start + 3h);
+    PostSamples(blackboard, {4.0});
+    windowAggregator.Advance(start + 4h);
+
+    REQUIRE(results.size() == 4);
+    REQUIRE(GetResult(results[0], "Count") == 2.0);
+    REQUIRE(GetResult(results[1], "Count") == 3.0);
+    REQUIRE(GetResult(results[1], "Max") == 10.0);
+    REQUIRE(GetResult(results[2], "Sum") == 13.0);
+
+    // Make sure the first pane has been evicted from the last window.
+    REQUIRE(GetResult(results[3], "Count") == 2.0);
+    REQUIRE(GetResult(results[3], "Min") == 4.0);
+    REQUIRE(GetResult(results[3], "P100") == 10.0);
+
+    windowAggregator.Advance(start + 5h);
+    REQUIRE(results.size() == 5);
+    REQUIRE(GetResult(results[4], "Count") == 1.0);
+    REQUIRE(GetResult(results[4], "P100") == 4.0);
+
+    // Make sure windows are posted only as long as they contain samples.
+    windowAggregator.Advance(start + 9h);
+    REQUIRE(results.size() == 6);
+    PostSamples(blackboard, {8.0});
+    windowAggregator.Advance(start + 10h);
+    REQUIRE(results.size() == 7);
+    REQUIRE(GetResult(results[6], "Count") == 1.0);
+    REQUIRE(GetResult(results[6], "Sum") == 8.0);
+}